@@ -0,0 +1,366 @@
+/*
+ * Arena traffic model, shared by the arenaSimulator example and extras/hostArenaSimulator.cpp so both run exactly the same simulation
+ *
+ * Shots are encoded with the library's own encoder, given random timing jitter, then overlaid on the receivers they hit. Overlapping shots are combined as the IR receiver would see them
+ * and shots closer together than the RMT idle threshold end up in the same capture. Captures are injected into a set of receivers and dataReceived() is polled at a fixed loop() interval,
+ * so a receiver that has not been serviced misses anything that arrives while it is busy
+ *
+ * The file including this provides
+ *
+ *   long arenaRandom(long low, long high)          random number, exclusive of high like Arduino's random()
+ *   void arenaRandomSeed(uint32_t seed)
+ *   uint32_t arenaMicros()                         clock for timing the decoding
+ *   void arenaPrint(const char* format, ...)       printf style output
+ *
+ * and the receivers, which have the receive API of milesTagClass. On the ESP32 that is milesTag itself
+ *
+ */
+#ifndef arenaModel_h
+#define arenaModel_h
+#include <milesTagEncoder.h>
+#include <milesTagDecoder.h>
+
+const uint8_t numberOfPlayers = 40;                       //Players firing
+const uint8_t numberOfReceivers = 16;                     //Virtual receivers, eg. the sensors on a group of vests
+const uint32_t simulationLength = 10e6;                   //Simulated game time in microseconds
+const uint32_t meanShotInterval = 250e3;                  //Mean time between shots from each player in microseconds
+const uint8_t spillPercentage = 20;                       //Chance a shot is also seen by a second receiver
+const int16_t markStretch = 35;                           //IR receiver modules lengthen pulses and shorten gaps by roughly this much in microseconds
+const int16_t jitter = 20;                                //Maximum random error in each pulse and gap in microseconds
+const uint8_t glitchPercentage = 3;                       //Chance of each pulse and each gap having a glitch in it
+const uint16_t maximumGlitchLength = 150;                 //Longest glitch in microseconds
+const uint16_t filterMinimumPulse = 200;                  //Glitch filter settings, shorter pulses are dropped
+const uint16_t filterMinimumGap = 200;                    //Shorter gaps are merged
+const uint32_t loopInterval = 5000;                       //Time between calls of loop() on the receiving device in microseconds
+const uint8_t decodesPerLoop = 1;                         //Calls to dataReceived() each loop
+const uint32_t idleThreshold = MILESTAG_PROFILE::receiveIdleThreshold;  //Gap that ends a capture, the same as the receiver's signal_range_max_ns
+const uint16_t maximumArrivals = 4096;                    //Shots arriving at a receiver, each shot is one or two arrivals
+const uint8_t maximumArrivalsPerCapture = 8;
+const uint8_t maximumSymbolsPerCapture = 64;              //Matches the size of the RMT receive buffer
+
+long arenaRandom(long low, long high);
+void arenaRandomSeed(uint32_t seed);
+uint32_t arenaMicros();
+void arenaPrint(const char* format, ...);
+
+struct arrival {
+  uint32_t start;                                         //Start time of the shot at the receiver
+  uint8_t player;
+  uint8_t damage;
+  uint8_t receiver;
+  bool reported;                                          //The shot has been reported by dataReceived()
+};
+struct capture {
+  uint32_t start;
+  uint32_t completed;                                     //When the RMT would have finished the capture
+  uint16_t firstArrival;
+  uint8_t numberOfArrivals;
+  uint8_t receiver;
+};
+struct interval {                                         //When the IR from one pulse of a shot is on
+  uint32_t on;
+  uint32_t off;
+};
+enum outcome : uint8_t {hit, collision, corrupted, receiverBusy, notPolled, misattributed, numberOfOutcomes};
+const char* const outcomeNames[numberOfOutcomes] = {"hit", "collision", "corrupted", "receiver busy", "not polled", "misattributed"};
+
+arrival* arrivals = nullptr;
+capture* captures = nullptr;
+interval* intervals = nullptr;
+uint16_t numberOfArrivals = 0;
+uint16_t numberOfCaptures = 0;
+uint32_t outcomes[numberOfOutcomes];
+milesTagSymbol symbols[maximumSymbolsPerCapture];
+
+int compareArrivals(const void* a, const void* b)         //Sort by receiver then start time
+{
+  const arrival* first = static_cast<const arrival*>(a);
+  const arrival* second = static_cast<const arrival*>(b);
+  if(first->receiver != second->receiver)
+  {
+    return first->receiver < second->receiver ? -1 : 1;
+  }
+  return first->start < second->start ? -1 : (first->start > second->start ? 1 : 0);
+}
+int compareCaptures(const void* a, const void* b)         //Sort by completion time, then position so the order is the same on every platform
+{
+  const capture* first = static_cast<const capture*>(a);
+  const capture* second = static_cast<const capture*>(b);
+  if(first->completed != second->completed)
+  {
+    return first->completed < second->completed ? -1 : 1;
+  }
+  return first->firstArrival < second->firstArrival ? -1 : (first->firstArrival > second->firstArrival ? 1 : 0);
+}
+int compareIntervals(const void* a, const void* b)
+{
+  const interval* first = static_cast<const interval*>(a);
+  const interval* second = static_cast<const interval*>(b);
+  return first->on < second->on ? -1 : (first->on > second->on ? 1 : 0);
+}
+
+uint32_t packetDuration()                                 //Nominal length of a damage packet, used to group arrivals into captures
+{
+  milesTagSymbol packet[maximumSymbolsPerCapture];
+  uint8_t length = milesTagEncoder::encodeDamage(0, 0, 100, packet, maximumSymbolsPerCapture);  //100 damage is all ones, the longest packet
+  return milesTagEncoder::duration(packet, length);
+}
+
+void generateTraffic()
+{
+  numberOfArrivals = 0;
+  for(uint8_t player = 0; player < numberOfPlayers; player++)
+  {
+    uint32_t shotTime = arenaRandom(0, meanShotInterval);
+    while(shotTime < simulationLength && numberOfArrivals + 2 <= maximumArrivals)
+    {
+      uint8_t damage = arenaRandom(1, 101);
+      uint8_t target = arenaRandom(0, numberOfReceivers);
+      arrivals[numberOfArrivals++] = {shotTime, player, damage, target, false};
+      if(arenaRandom(0, 100) < spillPercentage)           //Also seen by a neighbouring receiver
+      {
+        arrivals[numberOfArrivals++] = {shotTime + uint32_t(arenaRandom(0, 20)), player, damage, uint8_t((target + 1) % numberOfReceivers), false};
+      }
+      shotTime += arenaRandom(meanShotInterval/2, meanShotInterval*3/2);
+    }
+  }
+  qsort(arrivals, numberOfArrivals, sizeof(arrival), compareArrivals);
+}
+
+void groupCaptures()                                      //Arrivals closer together than the idle threshold are captured as one
+{
+  uint32_t longestPacket = packetDuration();
+  numberOfCaptures = 0;
+  for(uint16_t index = 0; index < numberOfArrivals; index++)
+  {
+    capture* current = numberOfCaptures > 0 ? &captures[numberOfCaptures - 1] : nullptr;
+    if(current != nullptr && current->receiver == arrivals[index].receiver &&
+      arrivals[index].start < current->completed && current->numberOfArrivals < maximumArrivalsPerCapture)
+    {
+      current->numberOfArrivals++;
+      if(arrivals[index].start + longestPacket + idleThreshold > current->completed)
+      {
+        current->completed = arrivals[index].start + longestPacket + idleThreshold;
+      }
+    }
+    else
+    {
+      captures[numberOfCaptures++] = {arrivals[index].start, arrivals[index].start + longestPacket + idleThreshold, index, 1, arrivals[index].receiver};
+    }
+  }
+  qsort(captures, numberOfCaptures, sizeof(capture), compareCaptures);
+}
+
+uint8_t buildCapture(const capture &current)              //Combine the IR from all the shots in a capture into the symbols the RMT would see
+{
+  uint16_t numberOfIntervals = 0;
+  milesTagSymbol packet[maximumSymbolsPerCapture];
+  for(uint8_t index = 0; index < current.numberOfArrivals; index++)
+  {
+    const arrival &shot = arrivals[current.firstArrival + index];
+    uint8_t length = milesTagEncoder::encodeDamage(shot.player, shot.player % 4, shot.damage, packet, maximumSymbolsPerCapture);
+    uint32_t time = shot.start;
+    for(uint8_t symbol = 0; symbol < length; symbol++)
+    {
+      intervals[numberOfIntervals].on = time;
+      time += packet[symbol].duration0 + markStretch + arenaRandom(-jitter, jitter + 1);
+      intervals[numberOfIntervals++].off = time;
+      time += packet[symbol].duration1 - markStretch + arenaRandom(-jitter, jitter + 1);
+    }
+  }
+  qsort(intervals, numberOfIntervals, sizeof(interval), compareIntervals);
+  uint8_t numberOfSymbols = 0;
+  uint32_t on = intervals[0].on;
+  uint32_t off = intervals[0].off;
+  for(uint16_t index = 1; index <= numberOfIntervals && numberOfSymbols < maximumSymbolsPerCapture; index++)
+  {
+    if(index < numberOfIntervals && intervals[index].on <= off)  //Overlapping IR merges into one pulse
+    {
+      off = intervals[index].off > off ? intervals[index].off : off;
+      continue;
+    }
+    symbols[numberOfSymbols].level0 = 1;
+    symbols[numberOfSymbols].duration0 = off - on < 0x7FFF ? off - on : 0x7FFF;
+    symbols[numberOfSymbols].level1 = 0;
+    if(index < numberOfIntervals)
+    {
+      symbols[numberOfSymbols].duration1 = intervals[index].on - off < 0x7FFF ? intervals[index].on - off : 0x7FFF;
+      on = intervals[index].on;
+      off = intervals[index].off;
+    }
+    else
+    {
+      symbols[numberOfSymbols].duration1 = 0;             //The RMT ends a capture with a zero length gap
+    }
+    numberOfSymbols++;
+  }
+  return numberOfSymbols;
+}
+
+void insertSymbol(uint8_t &numberOfSymbols, uint8_t position)  //Make space for a symbol, dropping the last one if the buffer is full as the RMT would
+{
+  if(numberOfSymbols < maximumSymbolsPerCapture)
+  {
+    numberOfSymbols++;
+  }
+  for(uint8_t index = numberOfSymbols - 1; index > position; index--)
+  {
+    symbols[index] = symbols[index - 1];
+  }
+}
+
+uint8_t addNoise(uint8_t numberOfSymbols)                 //Split some pulses with dropouts and put spikes in some gaps
+{
+  for(uint8_t index = 0; index < numberOfSymbols && numberOfSymbols < maximumSymbolsPerCapture; index++)
+  {
+    uint16_t glitch = arenaRandom(10, maximumGlitchLength + 1);
+    if(arenaRandom(0, 100) < glitchPercentage && symbols[index].duration0 > 3 * maximumGlitchLength)  //Dropout part way through a pulse
+    {
+      uint16_t before = arenaRandom(maximumGlitchLength, symbols[index].duration0 - 2 * maximumGlitchLength);
+      insertSymbol(numberOfSymbols, index + 1);
+      symbols[index + 1].duration0 = symbols[index].duration0 - before - glitch;
+      symbols[index + 1].duration1 = symbols[index].duration1;
+      symbols[index].duration0 = before;
+      symbols[index].duration1 = glitch;
+      index++;
+    }
+    else if(arenaRandom(0, 100) < glitchPercentage && symbols[index].duration1 > 3 * maximumGlitchLength)  //Spike part way through a gap
+    {
+      uint16_t before = arenaRandom(maximumGlitchLength, symbols[index].duration1 - 2 * maximumGlitchLength);
+      insertSymbol(numberOfSymbols, index + 1);
+      symbols[index + 1].level0 = 1;
+      symbols[index + 1].duration0 = glitch;
+      symbols[index + 1].level1 = 0;
+      symbols[index + 1].duration1 = symbols[index].duration1 - before - glitch;
+      symbols[index].duration1 = before;
+      index++;
+    }
+  }
+  return numberOfSymbols;
+}
+
+void recordLoss(const capture &current, outcome cause)
+{
+  for(uint8_t index = 0; index < current.numberOfArrivals; index++)
+  {
+    if(arrivals[current.firstArrival + index].reported == false)
+    {
+      outcomes[cause]++;
+    }
+  }
+}
+
+template<class receiverType> uint32_t runSimulation(receiverType &receivers, bool glitchFilter, uint32_t seed)  //Returns the number of hits captured
+{
+  arenaRandomSeed(seed);                                  //The same jitter and glitches with and without the filter
+  memset(outcomes, 0, sizeof(outcomes));
+  for(uint16_t index = 0; index < numberOfArrivals; index++)
+  {
+    arrivals[index].reported = false;
+  }
+  receivers.setGlitchFilter(glitchFilter ? filterMinimumPulse : 0, glitchFilter ? filterMinimumGap : 0);
+  uint16_t pending[numberOfReceivers];                    //Capture currently held by each receiver
+  uint32_t freeSince[numberOfReceivers];                  //When each receiver last resumed reception
+  for(uint8_t receiver = 0; receiver < numberOfReceivers; receiver++)
+  {
+    pending[receiver] = numberOfCaptures;
+    freeSince[receiver] = 0;
+  }
+  uint16_t nextCapture = 0;
+  uint32_t decodeTime = 0;
+  uint32_t longestLoop = 0;
+  uint32_t numberOfLoops = 0;
+  uint32_t endTime = simulationLength + packetDuration() + idleThreshold + loopInterval;
+  for(uint32_t now = loopInterval; now <= endTime; now += loopInterval)
+  {
+    while(nextCapture < numberOfCaptures && captures[nextCapture].completed <= now)   //Deliver everything the RMT would have finished since the last loop
+    {
+      const capture &current = captures[nextCapture];
+      if(receivers.receiverBusy(current.receiver) || freeSince[current.receiver] > current.start)
+      {
+        recordLoss(current, receiverBusy);
+      }
+      else
+      {
+        uint8_t numberOfSymbols = addNoise(buildCapture(current));
+        receivers.injectReceivedSymbols(current.receiver, symbols, numberOfSymbols);
+        pending[current.receiver] = nextCapture;
+      }
+      nextCapture++;
+    }
+    uint32_t loopStart = arenaMicros();                   //The loop() of the receiving device
+    for(uint8_t decode = 0; decode < decodesPerLoop; decode++)
+    {
+      if(receivers.dataReceived() == false)
+      {
+        break;
+      }
+      const capture &current = captures[pending[receivers.receivedReceiverIndex()]];
+      bool matched = false;
+      for(uint8_t index = 0; index < current.numberOfArrivals && matched == false; index++)
+      {
+        arrival &shot = arrivals[current.firstArrival + index];
+        if(shot.player == receivers.receivedPlayerId() && shot.player % 4 == receivers.receivedTeamId() && shot.reported == false)
+        {
+          shot.reported = true;
+          matched = true;
+          outcomes[hit]++;
+        }
+      }
+      if(matched == false)
+      {
+        outcomes[misattributed]++;
+      }
+      receivers.resumeReception();
+    }
+    uint32_t loopTime = arenaMicros() - loopStart;
+    decodeTime += loopTime;
+    longestLoop = loopTime > longestLoop ? loopTime : longestLoop;
+    numberOfLoops++;
+    for(uint8_t receiver = 0; receiver < numberOfReceivers; receiver++) //Anything left unreported by a receiver that is now free was lost in decoding
+    {
+      if(pending[receiver] < numberOfCaptures && receivers.receiverBusy(receiver) == false)
+      {
+        const capture &current = captures[pending[receiver]];
+        recordLoss(current, current.numberOfArrivals > 1 ? collision : corrupted);
+        pending[receiver] = numberOfCaptures;
+        freeSince[receiver] = now;
+      }
+    }
+  }
+  for(uint8_t receiver = 0; receiver < numberOfReceivers; receiver++)
+  {
+    if(pending[receiver] < numberOfCaptures)
+    {
+      recordLoss(captures[pending[receiver]], notPolled);
+      receivers.resumeReception();
+    }
+  }
+  arenaPrint("Glitch filter %s\r\n", glitchFilter ? "on" : "off");
+  arenaPrint("Hit capture rate %.1f%%\r\n", 100.0 * outcomes[hit] / numberOfArrivals);
+  for(uint8_t cause = collision; cause < numberOfOutcomes; cause++)
+  {
+    arenaPrint("  lost to %s: %u\r\n", outcomeNames[cause], unsigned(outcomes[cause]));
+  }
+  arenaPrint("Decode CPU time %uus total, %.1fus per loop, %uus longest loop, %.2f%% of the loop budget\r\n", unsigned(decodeTime), float(decodeTime)/numberOfLoops, unsigned(longestLoop), 100.0 * decodeTime / (float(numberOfLoops) * loopInterval));
+  return outcomes[hit];
+}
+
+template<class receiverType> void runArena(receiverType &receivers, uint32_t seed)  //Generate the traffic then simulate it without and with the glitch filter
+{
+  if(arrivals == nullptr)
+  {
+    arrivals = new arrival[maximumArrivals];
+    captures = new capture[maximumArrivals];
+    intervals = new interval[maximumArrivalsPerCapture * maximumSymbolsPerCapture];
+  }
+  arenaRandomSeed(seed);
+  generateTraffic();
+  groupCaptures();
+  arenaPrint("%u players, %u receivers, %.1fs simulated, loop() every %uus, %u%% glitches, seed %u\r\n", numberOfPlayers, numberOfReceivers, simulationLength/1e6, unsigned(loopInterval), glitchPercentage, unsigned(seed));
+  arenaPrint("%u shots arrived at receivers in %u captures\r\n", numberOfArrivals, numberOfCaptures);
+  uint32_t unfilteredHits = runSimulation(receivers, false, seed + 1);
+  uint32_t filteredHits = runSimulation(receivers, true, seed + 1);
+  arenaPrint("Glitch filter recovered %d hits\r\n", int(int32_t(filteredHits) - int32_t(unfilteredHits)));
+}
+#endif
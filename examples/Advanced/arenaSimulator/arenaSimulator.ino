@@ -0,0 +1,53 @@
+/*
+ * Arena simulator milesTag example
+ *
+ * It simulates many players firing at once at a group of virtual receivers to size sensor counts and loop() budgets
+ *
+ * Shots are encoded with the library's own encoder, given random timing jitter, then overlaid on the receivers they hit. Overlapping shots are combined as the IR receiver would see them
+ * and shots closer together than the RMT idle threshold end up in the same capture. Captures are fed into the normal receive path with injectReceivedSymbols() and
+ * dataReceived() is polled at a fixed loop() interval, so a receiver that has not been serviced misses anything that arrives while it is busy
+ *
+ * Glitches like those from sunlight or LED lighting can be added, splitting pulses and putting spikes in gaps. The simulation is then run with and without the
+ * software glitch filter to show how many hits it recovers
+ *
+ * No IR hardware is needed, the receivers are not connected to any pins
+ *
+ * The simulation itself is in arenaModel.h, which extras/hostArenaSimulator.cpp also uses to run it on a host. The settings are at the top of that file
+ *
+ */
+
+#include <milesTag.h>                                     //Include the milesTag library
+#include "arenaModel.h"                                   //The traffic model
+
+const uint32_t simulationSeed = 1;                        //Change this for different traffic, jitter and glitches
+
+long arenaRandom(long low, long high)
+{
+  return random(low, high);
+}
+void arenaRandomSeed(uint32_t seed)
+{
+  randomSeed(seed);                                       //A fixed seed so runs can be repeated
+}
+uint32_t arenaMicros()
+{
+  return micros();
+}
+void arenaPrint(const char* format, ...)
+{
+  char line[160];
+  va_list arguments;
+  va_start(arguments, format);
+  vsnprintf(line, sizeof(line), format, arguments);
+  va_end(arguments);
+  Serial.print(line);
+}
+
+void setup() {
+  Serial.begin(115200);                                   //Set up Serial for output
+  milesTag.begin(milesTag.receiver, 1, numberOfReceivers); //Receivers are only fed by the simulation so no pins are set
+  runArena(milesTag, simulationSeed);
+}
+
+void loop() {
+}
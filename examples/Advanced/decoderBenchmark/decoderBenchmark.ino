@@ -0,0 +1,65 @@
+/*
+ * Decoder benchmark milesTag example
+ * 
+ * It builds a batch of synthetic captures, as if from thousands of sensors, with some timing jitter and some corrupted packets then decodes them repeatedly with the batch decoder and reports packets/s
+ * 
+ * The decoder does not use the RMT peripheral so the same code can be used on a host, eg. a Linux based referee collecting raw captures from many sensors, where it uses SSE/AVX2 and threads if available
+ * 
+ */
+
+#include <milesTag.h>                                     //Include the milesTag library
+
+const uint16_t numberOfSensors = 2048;                    //Number of simulated sensor captures in a batch
+const uint8_t symbolsPerCapture = 15;                     //A damage packet is a start symbol and 14 bits
+const uint8_t corruptOneIn = 20;                          //Corrupt some captures so the failure paths are also measured
+const uint8_t numberOfRuns = 10;
+
+milesTagSymbol* symbols = nullptr;                        //Raw captures, one after another
+const milesTagSymbol** captures = nullptr;                //Pointer to the start of each capture
+uint8_t* numberOfSymbols = nullptr;                       //Length of each capture
+milesTagPacket* packets = nullptr;                        //Decoded results
+
+void addSymbol(milesTagSymbol &symbol, uint16_t onTime, uint16_t offTime)
+{
+  symbol.level0 = 1;
+  symbol.duration0 = onTime + random(-5, 61);             //Add some jitter, IR receivers stretch pulses and shorten gaps
+  symbol.level1 = 0;
+  symbol.duration1 = offTime > 0 ? offTime - random(-5, 61) : 0;
+}
+
+void setup() {
+  Serial.begin(115200);                                   //Set up Serial for output
+  symbols = new milesTagSymbol[numberOfSensors * symbolsPerCapture];
+  captures = new const milesTagSymbol*[numberOfSensors];
+  numberOfSymbols = new uint8_t[numberOfSensors];
+  packets = new milesTagPacket[numberOfSensors];
+  for(uint16_t sensor = 0; sensor < numberOfSensors; sensor++)
+  {
+    milesTagSymbol* capture = &symbols[sensor * symbolsPerCapture];
+    uint8_t data[2] = {uint8_t(random(0,128)), uint8_t((random(0,4) << 6) | (random(0,16) << 2))};  //Player ID, team ID and damage bitmask
+    addSymbol(capture[0], 2400, 600);                     //Start
+    for(uint8_t bit = 0; bit < symbolsPerCapture - 1; bit++)
+    {
+      addSymbol(capture[bit + 1], bitRead(data[bit/8], 7 - bit%8) ? 1200 : 600, bit < symbolsPerCapture - 2 ? 600 : 0);
+    }
+    if(sensor % corruptOneIn == 0)
+    {
+      capture[random(1, symbolsPerCapture)].duration0 = 900; //Neither a one nor a zero
+    }
+    captures[sensor] = capture;
+    numberOfSymbols[sensor] = symbolsPerCapture;
+  }
+  Serial.printf("Decoding %u captures per batch with the %s kernel\r\n", numberOfSensors, milesTagDecoder::kernel());
+}
+
+void loop() {
+  uint32_t validPackets = 0;
+  uint32_t start = micros();
+  for(uint8_t run = 0; run < numberOfRuns; run++)
+  {
+    validPackets = milesTagDecoder::decodeBatch(captures, numberOfSymbols, numberOfSensors, packets);   //One thread, to give a per core figure
+  }
+  uint32_t duration = micros() - start;
+  Serial.printf("%u/%u valid, %.0f packets/s per core, %.2f microseconds per packet\r\n", validPackets, numberOfSensors, (float(numberOfSensors) * numberOfRuns * 1e6) / duration, float(duration) / (float(numberOfSensors) * numberOfRuns));
+  delay(5e3);
+}
@@ -0,0 +1,55 @@
+/*
+ * Game statistics milesTag example
+ * 
+ * It records hits taken and shots fired on a combo device and every 5s makes a snapshot containing only what changed since the last one
+ * 
+ * The snapshot is printed as hex here but is intended to be sent over WiFi to a game server, which can rebuild the same tables with applySnapshot()
+ * 
+ */
+
+#include <milesTag.h>                             //Include the milesTag library
+#include <milesTagStats.h>                        //Include the optional statistics module
+
+milesTagStats stats;                              //Flat tables for 128 players, 4 teams and up to 8 transmitters
+uint8_t snapshot[128];                            //Anything that does not fit is sent in the next snapshot
+uint32_t lastTransmit = 0;
+uint32_t lastSnapshot = 0;
+
+void setup() {
+  Serial.begin(115200);                           //Set up Serial for debug output
+  milesTag.begin(milesTag.combo);                 //Initialise as a 'combo' device
+  milesTag.setTransmitPin(12);                    //Set the transmit pin, which is mandatory
+  milesTag.setReceivePin(34);                     //Set the receive pin, which is mandatory
+  milesTag.setPlayerId(random(0,128));            //Set random player ID 0-127
+  milesTag.setTeamId(random(0,4));                //Set random team ID 0-3
+}
+
+void loop() {
+  if(milesTag.dataReceived())
+  {
+    if(milesTag.receivedDamage() && milesTag.receivedPlayerId() != milesTag.playerId())  //Ignore reflected 'self' hits
+    {
+      stats.recordHit(milesTag.receivedPlayerId(), milesTag.receivedTeamId(), milesTag.receivedDamage(), millis());
+    }
+    milesTag.resumeReception();
+  }
+  if(millis() - lastTransmit > 1e3)
+  {
+    lastTransmit = millis();
+    if(milesTag.transmitDamage(random(1,101)))
+    {
+      stats.recordShot(0, millis());
+    }
+  }
+  if(millis() - lastSnapshot > 5e3)
+  {
+    lastSnapshot = millis();
+    uint16_t length = stats.serialiseSnapshot(snapshot, sizeof(snapshot), millis());
+    Serial.printf("Snapshot %u, %u bytes, %u hits and %u damage taken in total:", stats.snapshotSequence(), length, stats.totalHitsTaken(), stats.totalDamageTaken());
+    for(uint16_t index = 0; index < length; index++)
+    {
+      Serial.printf(" %02x", snapshot[index]);
+    }
+    Serial.println();
+  }
+}
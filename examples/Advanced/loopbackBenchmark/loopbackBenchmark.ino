@@ -0,0 +1,38 @@
+/*
+ * Loopback benchmark milesTag example
+ * 
+ * A combo device fires numbered packets from its transmitter at its own receiver and reports the end to end latency, from starting each transmission
+ * to the packet being decoded, the sustained packet rate and any losses
+ * 
+ * For an optical loopback point the IR LED at the receiver, a few centimetres apart is plenty. With opticalLoopback set to false no receive pin is
+ * set and the link is simulated, which measures the library alone and is comparable across boards and builds. The packets are still sent with rmt_transmit() on the
+ * transmit pin, so a simulated run needs the transmitter configured and an ESP32 just the same
+ * 
+ * Each packet is sent as soon as the previous one is decoded, so the packet rate is the most a single receiver can take from a single emitter
+ * 
+ */
+
+#include <milesTag.h>                                         //Include the milesTag library
+
+const bool opticalLoopback = true;                            //False to simulate the link
+const uint16_t numberOfPackets = 200;                         //Up to 512
+
+void setup() {
+  Serial.begin(115200);                                       //Set up Serial for output
+  milesTag.begin(milesTag.combo);                             //Initialise as a 'combo' device
+  milesTag.setTransmitPin(12);                                //Set the transmit pin, which is mandatory
+  if(opticalLoopback) {
+    milesTag.setReceivePin(34);                               //Set the receive pin
+  }
+}
+
+void loop() {
+  milesTagBenchmarkResult result = milesTag.loopbackBenchmark(numberOfPackets);
+  Serial.printf("%s link, %u sent, %u received, %u lost in %ums, %.1f packets/s\r\n", result.simulated ? "Simulated" : "Optical", result.sent, result.received, result.lost, result.duration/1000, result.packetsPerSecond);
+  Serial.printf("Latency min:%uus median:%uus 90%%:%uus 99%%:%uus max:%uus, rmt_transmit() took %uus\r\n", result.minimumLatency, result.medianLatency, result.percentile90Latency, result.percentile99Latency, result.maximumLatency, result.meanQueueTime);
+  if(result.timedOut)
+  {
+    Serial.println("Timed out, the transmitter stopped finishing its packets");
+  }
+  delay(10e3);
+}
@@ -0,0 +1,32 @@
+/*
+ * Packet sequence milesTag example
+ * 
+ * It builds a 'burst fire' sequence of three damage packets followed by a control packet and sends it every 5s as a single RMT transaction
+ * 
+ * The RMT times the gaps between the packets, so they are exact however busy the CPU is. Receivers only see separate packets if the gaps are
+ * longer than their idle threshold and the receiving sketch resumes reception before the next one arrives
+ * 
+ */
+
+#include <milesTag.h>                                         //Include the milesTag library
+
+uint8_t controlPacket[3] = {0x83, 0x04, 0xE8};                //A MilesTag 2 "respawn" system command, as an example of a follow-up packet
+
+void setup() {
+  Serial.begin(115200);                                       //Set up Serial for debug output
+  //milesTag.debug(Serial);                                     //Send milesTag debug output to Serial (optional)
+  milesTag.begin();                                           //Simple single transmitter requires no other initialisation
+  milesTag.setTransmitPin(12);                                //Set the transmit pin, which is mandatory
+  milesTag.startSequence();                                   //Build the sequence once, it can be sent as often as needed
+  milesTag.addDamageToSequence(10);                           //The gap before the first packet is ignored
+  milesTag.addDamageToSequence(10, 20e3);                     //20ms after the previous packet ends
+  milesTag.addDamageToSequence(10, 20e3);
+  milesTag.addPacketToSequence(controlPacket, 24);            //With the default gap, the shortest a receiver will reliably see as a separate packet
+  Serial.printf("Sequence is %uus long\r\n", milesTag.sequenceDuration());
+}
+
+void loop() {
+  Serial.println(F("Firing burst"));
+  milesTag.transmitSequence();                                //Send the whole sequence from the first transmitter
+  delay(5e3);
+}
@@ -0,0 +1,45 @@
+/*
+ * Transmit scheduler milesTag example
+ * 
+ * A twin transmitter device fires a shot every 8ms, more than the two transmitters can send, while also sending a high priority control packet every 100ms
+ * 
+ * Shots are queued with a 30ms deadline so they are dropped rather than sent late, the control packets are queued at high priority so they always go out on the next free transmitter
+ * 
+ * Every 5s the queue statistics for each priority are printed
+ * 
+ */
+
+#include <milesTag.h>                                         //Include the milesTag library
+
+int8_t emitterPins[2] = {12, 13};                             //GPIO pins are in an array
+uint32_t lastShot = 0;
+uint32_t lastControlPacket = 0;
+uint32_t lastReport = 0;
+uint8_t controlPacket[3] = {0x83, 0x04, 0xE8};                //A MilesTag 2 "respawn" system command
+
+void setup() {
+  Serial.begin(115200);                                       //Set up Serial for debug output
+  milesTag.begin(milesTag.transmitter,2);                     //Twin transmitter requires fuller initialisation
+  milesTag.setTransmitPins(emitterPins);                      //Set the transmit pins, which are mandatory
+}
+
+void loop() {
+  if(millis() - lastShot > 8) {
+    lastShot = millis();
+    milesTag.queueDamage(10, milesTag.normalPriority, 30e3);  //Queue 10 damage for any free transmitter, dropping it if it is not sent within 30ms
+  }
+  if(millis() - lastControlPacket > 100) {
+    lastControlPacket = millis();
+    milesTag.queuePacket(controlPacket, 24, milesTag.highPriority); //Queue a control packet, which is sent before any shots and never dropped
+  }
+  milesTag.serviceTransmitQueue();                            //Send whatever can be sent now
+  if(millis() - lastReport > 5e3) {
+    lastReport = millis();
+    const char* names[milesTag.numberOfPriorities] = {"high", "normal", "low"};
+    for(uint8_t priority = 0; priority < milesTag.numberOfPriorities; priority++) {
+      milesTagQueueStats stats = milesTag.transmitQueueStats(static_cast<milesTagClass::transmitPriority>(priority));
+      Serial.printf("%-6s depth:%u/%u sent:%u late:%u full:%u no transmitter:%u latency mean:%uus worst:%uus\r\n", names[priority], stats.depth, stats.maximumDepth, stats.sent, stats.droppedLate, stats.droppedFull, stats.droppedNoTransmitter, stats.meanLatency, stats.worstLatency);
+    }
+    milesTag.resetTransmitQueueStats();
+  }
+}
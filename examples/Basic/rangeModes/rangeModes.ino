@@ -0,0 +1,27 @@
+/*
+ * Range mode milesTag example
+ * 
+ * It sends damage every 5s from a single transmitter, switching between long and short range carrier profiles each time
+ * 
+ * The profiles change the carrier duty cycle, and so the average LED power, without tearing down the RMT channel. A change takes effect at the next transmission and the time it took is available from carrierSwitchTime()
+ * 
+ */
+
+#include <milesTag.h>                                         //Include the milesTag library
+
+bool shortRangeMode = false;
+
+void setup() {
+  Serial.begin(115200);                                       //Set up Serial for debug output
+  //milesTag.debug(Serial);                                     //Send milesTag debug output to Serial (optional)
+  milesTag.begin();                                           //Simple single transmitter requires no other initialisation
+  milesTag.setTransmitPin(12);                                //Set the transmit pin, which is mandatory
+}
+
+void loop() {
+  shortRangeMode = !shortRangeMode;
+  milesTag.setCarrierProfile(shortRangeMode ? milesTag.shortRange : milesTag.longRange); //Change the carrier on the first transmitter, which is the default
+  milesTag.transmitDamage();                                  //The new carrier is applied just before this is sent
+  Serial.printf("Fired in %s range mode, carrier switch took %uus\r\n", shortRangeMode ? "short" : "long", milesTag.carrierSwitchTime());
+  delay(5e3);
+}
@@ -21,7 +21,15 @@ void loop() {
       Serial.print(F(" damage from player ID:"));
       Serial.print(milesTag.receivedPlayerId());
       Serial.print(F(" team ID:"));
-      Serial.println(milesTag.receivedTeamId());
+      Serial.print(milesTag.receivedTeamId());
+      milesTagSignalQuality quality = milesTag.receivedSignalQuality(); //How far the pulse timings were from nominal, useful for spotting weak emitters or badly placed receivers
+      Serial.print(F(" pulse deviation mean:"));
+      Serial.print(quality.meanPulseDeviation);
+      Serial.print(F("us worst:"));
+      Serial.print(quality.worstPulseDeviation);
+      Serial.print(F("us gap jitter:"));
+      Serial.print(quality.gapJitter);
+      Serial.println(F("us"));
     }
     else
     {
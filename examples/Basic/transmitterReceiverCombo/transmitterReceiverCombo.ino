@@ -1,6 +1,7 @@
 /*
  * Combo milesTag example, sends random damage every 5s from a single transmitter device while also accepting hits
- * note a weapon will often 'shoot itself' due to reflected IR so this sketch ignores 'self' hits by comparing player and team IDs
+ * note a weapon will often 'shoot itself' due to reflected IR so this sketch has the library discard anything captured while it is transmitting
+ * and also ignores any other 'self' hits by comparing player and team IDs
  * 
  * You can choose to ignore these reflected hits or not in your own code
  */
@@ -14,6 +15,7 @@ void setup() {
   milesTag.begin(milesTag.combo);         //Initialise as a 'combo' device
   milesTag.setTransmitPin(12);            //Set the transmit pin, which is mandatory
   milesTag.setReceivePin(34);             //Set the receive pin, which is mandatory
+  milesTag.setSelfTransmissionGating();   //Discard captures made while transmitting, or up to 1ms afterwards, before they are parsed (optional)
   milesTag.setPlayerId(random(0,128));    //Set random player ID 0-127
   milesTag.setTeamId(random(0,4));        //Set random team ID 0-3
 }
@@ -48,5 +50,7 @@ void loop() {
     lastTransmit = millis();
     Serial.println(F("Firing random damage"));
     milesTag.transmitDamage(random(1,101)); //Transmit 1-100 damage from the first transmitter. Note milesTag only has 16 damage steps (1,2,4,5,7,10,15,17,20,25,30,35,40,50,75,100) so this will often be rounded down before sending
+    Serial.print(milesTag.suppressedSelfEchoes());
+    Serial.println(F(" self echoes discarded so far"));
   }
 }
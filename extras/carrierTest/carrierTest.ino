@@ -0,0 +1,54 @@
+/*
+ * Carrier settings test for a twin transmitter device
+ *
+ * Checks that setCarrierFrequency() and setDutyCycle() without a transmitter index change every transmitter, as they always have, and that with an index they change just that one
+ *
+ * Runs on an ESP32, no IR hardware is needed. Results are printed to Serial, ending in PASS or FAIL
+ *
+ */
+
+#include <milesTag.h>                         //Include the milesTag library
+
+int8_t emitterPins[2] = {12, 13};             //GPIO pins are in an array
+uint8_t failures = 0;
+
+void check(const char* name, uint32_t value, uint32_t expected) {
+  Serial.printf("%-44s %6u %s\r\n", name, value, value == expected ? "ok" : "WRONG");
+  if(value != expected) {
+    failures++;
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+  milesTag.setCarrierFrequency(40000);        //Before begin(), every transmitter that could exist
+  milesTag.setDutyCycle(20, 1);               //Just the second
+  milesTag.begin(milesTag.transmitter,2);
+  milesTag.setTransmitPins(emitterPins);
+  check("Before begin() frequency, transmitter 0", milesTag.carrierFrequency(0), 40000);
+  check("Before begin() frequency, transmitter 1", milesTag.carrierFrequency(1), 40000);
+  check("Before begin() duty cycle, transmitter 0", milesTag.dutyCycle(0), 50);
+  check("Before begin() duty cycle, transmitter 1", milesTag.dutyCycle(1), 20);
+  milesTag.setCarrierFrequency(38000);        //One argument, both transmitters
+  milesTag.setDutyCycle(30);
+  check("All frequency, transmitter 0", milesTag.carrierFrequency(0), 38000);
+  check("All frequency, transmitter 1", milesTag.carrierFrequency(1), 38000);
+  check("All duty cycle, transmitter 0", milesTag.dutyCycle(0), 30);
+  check("All duty cycle, transmitter 1", milesTag.dutyCycle(1), 30);
+  milesTag.setCarrierFrequency(56000, 0);     //With an index, just that transmitter
+  milesTag.setDutyCycle(10, 1);
+  check("Indexed frequency, transmitter 0", milesTag.carrierFrequency(0), 56000);
+  check("Indexed frequency, transmitter 1", milesTag.carrierFrequency(1), 38000);
+  check("Indexed duty cycle, transmitter 0", milesTag.dutyCycle(0), 30);
+  check("Indexed duty cycle, transmitter 1", milesTag.dutyCycle(1), 10);
+  milesTag.setCarrierProfile(milesTag.mediumRange, milesTag.allTransmitters);
+  check("Profile duty cycle, transmitter 0", milesTag.dutyCycle(0), 25);
+  check("Profile duty cycle, transmitter 1", milesTag.dutyCycle(1), 25);
+  milesTag.transmitDamage(1, 0);              //Applies the pending changes to the RMT channels
+  milesTag.transmitDamage(1, 1);
+  Serial.println(failures == 0 ? F("PASS") : F("FAIL"));
+}
+
+void loop() {
+}
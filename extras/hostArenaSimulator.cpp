@@ -0,0 +1,127 @@
+/*
+ *	Host build of the arenaSimulator example
+ *
+ *	https://github.com/ncmreynolds/milesTag
+ *
+ *	Released under LGPL-2.1 see https://github.com/ncmreynolds/milesTag/LICENSE for full license
+ *
+ *	Runs the traffic model in examples/Advanced/arenaSimulator/arenaModel.h, the same file the example uses, as a plain C++ program. milesTagClass needs the Arduino core
+ *	so the receivers are a small stand in with its receive API. Each capture goes through milesTagDecoder::decodeCapture(), the glitch filter and decoder milesTagClass
+ *	itself uses, and the receivers are polled, discarded and resumed in the same order as milesTagClass::dataReceived() and resumeReception()
+ *
+ *	build, from the library folder:	g++ -O2 -Isrc extras/hostArenaSimulator.cpp src/milesTagEncoder.cpp src/milesTagDecoder.cpp -o hostArenaSimulator
+ *
+ *	usage: hostArenaSimulator [seed]
+ *
+ *	Decode CPU time is for the host, not an ESP32, run the example on the device for that
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <chrono>
+#include <random>
+#include "../examples/Advanced/arenaSimulator/arenaModel.h"
+
+std::mt19937 generator;
+const auto startTime = std::chrono::steady_clock::now();
+
+long arenaRandom(long low, long high)
+{
+	return std::uniform_int_distribution<long>(low, high - 1)(generator);
+}
+void arenaRandomSeed(uint32_t seed)
+{
+	generator.seed(seed);
+}
+uint32_t arenaMicros()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+void arenaPrint(const char* format, ...)
+{
+	va_list arguments;
+	va_start(arguments, format);
+	vprintf(format, arguments);
+	va_end(arguments);
+}
+
+class hostReceivers	{									//The receive API of milesTagClass, without the RMT
+
+	public:
+		void setGlitchFilter(uint16_t minimumPulse, uint16_t minimumGap)
+		{
+			minimum_pulse_ = minimumPulse;
+			minimum_gap_ = minimumGap;
+		}
+		bool receiverBusy(uint8_t receiverIndex)
+		{
+			return number_of_received_symbols_[receiverIndex] > 0;
+		}
+		bool injectReceivedSymbols(uint8_t receiverIndex, const milesTagSymbol* symbols, uint8_t numberOfSymbols)
+		{
+			if(number_of_received_symbols_[receiverIndex] > 0)
+			{
+				return false;
+			}
+			memcpy(received_symbols_[receiverIndex], symbols, numberOfSymbols * sizeof(milesTagSymbol));
+			number_of_received_symbols_[receiverIndex] = numberOfSymbols;
+			return true;
+		}
+		bool dataReceived()
+		{
+			for(uint8_t index = 0; index < numberOfReceivers; index++)
+			{
+				if(number_of_received_symbols_[index] > 0)
+				{
+					uint8_t number_of_symbols_ = number_of_received_symbols_[index];
+					if(milesTagDecoder::decodeCapture(received_symbols_[index], number_of_symbols_, received_packet_, minimum_pulse_, minimum_gap_) == true)
+					{
+						received_receiver_index_ = index;
+						return true;
+					}
+					number_of_received_symbols_[index] = 0;	//Invalid message, discard and restart reception
+				}
+			}
+			return false;
+		}
+		uint8_t receivedReceiverIndex()
+		{
+			return received_receiver_index_;
+		}
+		uint8_t receivedPlayerId()
+		{
+			return received_packet_.playerId;
+		}
+		uint8_t receivedTeamId()
+		{
+			return received_packet_.teamId;
+		}
+		bool resumeReception()							//The first busy receiver, as milesTagClass does
+		{
+			for(uint8_t index = 0; index < numberOfReceivers; index++)
+			{
+				if(number_of_received_symbols_[index] > 0)
+				{
+					number_of_received_symbols_[index] = 0;
+					return true;
+				}
+			}
+			return false;
+		}
+	private:
+		milesTagSymbol received_symbols_[numberOfReceivers][maximumSymbolsPerCapture];
+		uint8_t number_of_received_symbols_[numberOfReceivers] = {};
+		milesTagPacket received_packet_;
+		uint8_t received_receiver_index_ = 0;
+		uint16_t minimum_pulse_ = 0;
+		uint16_t minimum_gap_ = 0;
+};
+hostReceivers receivers;
+
+int main(int argc, char* argv[])
+{
+	uint32_t seed = argc > 1 ? strtoul(argv[1], nullptr, 0) : 1;
+	runArena(receivers, seed);
+	return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ *	Host benchmark and self check for milesTagDecoder
+ *
+ *	https://github.com/ncmreynolds/milesTag
+ *
+ *	Released under LGPL-2.1 see https://github.com/ncmreynolds/milesTag/LICENSE for full license
+ *
+ *	Builds a batch of synthetic captures, as the decoderBenchmark example does, then
+ *
+ *	- checks every SIMD kernel the CPU has classifies symbols exactly as the scalar code does, including durations on the edges of the receive windows
+ *	- reports packets/s per core for each kernel
+ *	- reports packets/s for decodeBatch() spread across 1, 2, 4... threads up to one per core
+ *
+ *	build, from the library folder:	g++ -O2 -pthread -Isrc extras/hostDecoderBenchmark.cpp src/milesTagDecoder.cpp -o hostDecoderBenchmark
+ *
+ *	Exits with 1 if any kernel disagrees with the scalar code
+ *
+ */
+#include "milesTagDecoder.h"
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+const uint32_t numberOfCaptures = 65536;				//Number of simulated sensor captures in a batch
+const uint8_t symbolsPerCapture = MILESTAG_PROFILE::damagePacketBits + 1;		//A damage packet is a start symbol and 14 bits
+const uint8_t corruptOneIn = 20;						//Corrupt some captures so the failure paths are also measured
+const uint32_t numberOfCheckSymbols = 1 << 20;			//Random symbols compared against the scalar classification
+const double minimumRunTime = 0.5;						//Seconds each measurement is repeated for
+const char* kernels[3] = {"scalar", "sse2", "avx2"};
+
+std::mt19937 generator(1);
+
+uint16_t random_between(int32_t low, int32_t high)		//Inclusive
+{
+	return std::uniform_int_distribution<int32_t>(low, high)(generator);
+}
+void add_symbol(milesTagSymbol &symbol, uint16_t onTime, uint16_t offTime)
+{
+	symbol.level0 = 1;
+	symbol.duration0 = onTime + random_between(-5, 60);		//Add some jitter, IR receivers stretch pulses and shorten gaps
+	symbol.level1 = 0;
+	symbol.duration1 = offTime > 0 ? offTime - random_between(-5, 60) : 0;
+}
+bool same_packet(const milesTagPacket &a, const milesTagPacket &b)
+{
+	return a.status == b.status && memcmp(a.data, b.data, sizeof(a.data)) == 0 && a.numberOfBits == b.numberOfBits && a.playerId == b.playerId && a.teamId == b.teamId && a.damage == b.damage &&
+		a.quality.meanPulseDeviation == b.quality.meanPulseDeviation && a.quality.worstPulseDeviation == b.quality.worstPulseDeviation &&
+		a.quality.gapJitter == b.quality.gapJitter && a.quality.numberOfPulses == b.quality.numberOfPulses;
+}
+uint32_t check_classification(const char* kernel)		//Returns the number of symbols classified differently to classifySymbol()
+{
+	static const uint16_t edges[] = {0, 1,					//Durations either side of every watermark, plus a few anywhere
+		milesTagDecoder::zeroBitLowWatermark, milesTagDecoder::zeroBitLowWatermark + 1, milesTagDecoder::zeroBitHighWatermark - 1, milesTagDecoder::zeroBitHighWatermark,
+		milesTagDecoder::oneBitLowWatermark, milesTagDecoder::oneBitLowWatermark + 1, milesTagDecoder::oneBitHighWatermark - 1, milesTagDecoder::oneBitHighWatermark,
+		milesTagDecoder::startBitLowWatermark, milesTagDecoder::startBitLowWatermark + 1, milesTagDecoder::startBitHighWatermark - 1, milesTagDecoder::startBitHighWatermark,
+		milesTagDecoder::gapLowWatermark, milesTagDecoder::gapLowWatermark + 1, milesTagDecoder::gapHighWatermark - 1, milesTagDecoder::gapHighWatermark,
+		0x7FFE, 0x7FFF};
+	std::vector<milesTagSymbol> symbols(numberOfCheckSymbols);
+	for(milesTagSymbol &symbol : symbols)
+	{
+		symbol.val = generator();
+		if(random_between(0, 1) == 1)	//Half of them close to real symbols
+		{
+			symbol.duration0 = edges[random_between(0, sizeof(edges)/sizeof(edges[0]) - 1)];
+			symbol.duration1 = edges[random_between(0, sizeof(edges)/sizeof(edges[0]) - 1)];
+			symbol.level0 = random_between(0, 3) != 0;
+			symbol.level1 = random_between(0, 3) == 0;
+		}
+	}
+	milesTagDecoder::setKernel(kernel);
+	uint32_t mismatches = 0;
+	uint8_t classification[255];
+	for(uint32_t first = 0; first < numberOfCheckSymbols; first += 255)
+	{
+		uint8_t length = numberOfCheckSymbols - first < 255 ? numberOfCheckSymbols - first : 255;
+		length = random_between(1, length);		//Vary the length so the scalar tails of the SIMD kernels are checked too
+		milesTagDecoder::classifySymbols(&symbols[first], length, classification);
+		for(uint8_t index = 0; index < length; index++)
+		{
+			mismatches += classification[index] != milesTagDecoder::classifySymbol(symbols[first + index]);
+		}
+	}
+	return mismatches;
+}
+double packets_per_second(const milesTagSymbol* const* captures, const uint8_t* numberOfSymbols, milesTagPacket* packets, uint8_t numberOfThreads, uint32_t &validPackets)
+{
+	uint32_t runs = 0;
+	auto start = std::chrono::steady_clock::now();
+	double elapsed = 0;
+	while(elapsed < minimumRunTime)
+	{
+		validPackets = milesTagDecoder::decodeBatch(captures, numberOfSymbols, numberOfCaptures, packets, numberOfThreads);
+		runs++;
+		elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+	return double(numberOfCaptures) * runs / elapsed;
+}
+int main()
+{
+	std::vector<milesTagSymbol> symbols(numberOfCaptures * symbolsPerCapture);	//Raw captures, one after another
+	std::vector<const milesTagSymbol*> captures(numberOfCaptures);				//Pointer to the start of each capture
+	std::vector<uint8_t> numberOfSymbols(numberOfCaptures, symbolsPerCapture);	//Length of each capture
+	std::vector<milesTagPacket> packets(numberOfCaptures);						//Decoded results
+	std::vector<milesTagPacket> scalarPackets(numberOfCaptures);				//Decoded by the scalar kernel, to compare with
+	for(uint32_t capture_index = 0; capture_index < numberOfCaptures; capture_index++)
+	{
+		milesTagSymbol* capture = &symbols[capture_index * symbolsPerCapture];
+		uint8_t data[2] = {uint8_t(random_between(0, 127)), uint8_t((random_between(0, 3) << 6) | (random_between(0, 15) << 2))};	//Player ID, team ID and damage bitmask
+		add_symbol(capture[0], MILESTAG_PROFILE::startOnTime, MILESTAG_PROFILE::offTime);	//Start
+		for(uint8_t bit = 0; bit < symbolsPerCapture - 1; bit++)
+		{
+			add_symbol(capture[bit + 1], (data[bit/8] >> (7 - bit%8)) & 0x01 ? MILESTAG_PROFILE::oneOnTime : MILESTAG_PROFILE::zeroOnTime,
+				bit < symbolsPerCapture - 2 ? MILESTAG_PROFILE::offTime : 0);
+		}
+		if(capture_index % corruptOneIn == 0)
+		{
+			capture[random_between(1, symbolsPerCapture - 1)].duration0 = (MILESTAG_PROFILE::zeroOnTime + MILESTAG_PROFILE::oneOnTime) / 2;	//Neither a one nor a zero
+		}
+		captures[capture_index] = capture;
+	}
+	int result = 0;
+	printf("%u captures of %u symbols per batch, best kernel on this CPU is %s\n\n", numberOfCaptures, symbolsPerCapture, milesTagDecoder::kernel());
+	printf("%-8s %12s %16s %12s\n", "Kernel", "Mismatches", "Packets/s/core", "Valid");
+	for(const char* kernel : kernels)
+	{
+		if(milesTagDecoder::setKernel(kernel) == false)
+		{
+			printf("%-8s %12s\n", kernel, "unsupported");
+			continue;
+		}
+		uint32_t mismatches = check_classification(kernel);
+		uint32_t validPackets = 0;
+		double rate = packets_per_second(captures.data(), numberOfSymbols.data(), packets.data(), 1, validPackets);
+		if(kernel == kernels[0])
+		{
+			scalarPackets = packets;
+		}
+		else
+		{
+			for(uint32_t capture_index = 0; capture_index < numberOfCaptures; capture_index++)	//The whole decode must match as well, not just the classification
+			{
+				mismatches += same_packet(packets[capture_index], scalarPackets[capture_index]) == false;
+			}
+		}
+		printf("%-8s %12u %16.0f %7u/%u\n", kernel, mismatches, rate, validPackets, numberOfCaptures);
+		if(mismatches > 0)
+		{
+			result = 1;
+		}
+	}
+	for(uint8_t level = 3; level > 0 && milesTagDecoder::setKernel(kernels[level - 1]) == false; level--);	//Back to the best available
+	printf("\n%-8s %16s %16s\n", "Threads", "Packets/s", "Packets/s/thread");
+	uint32_t cores = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+	cores = cores < milesTagDecoder::maximumBatchThreads ? cores : milesTagDecoder::maximumBatchThreads;	//decodeBatch() takes a uint8_t thread count and clamps to this anyway
+	for(uint32_t numberOfThreads = 1; numberOfThreads <= cores; numberOfThreads = numberOfThreads < cores && numberOfThreads * 2 > cores ? cores : numberOfThreads * 2)	//Powers of two, then all of them
+	{
+		uint32_t validPackets = 0;
+		double rate = packets_per_second(captures.data(), numberOfSymbols.data(), packets.data(), numberOfThreads, validPackets);
+		printf("%-8u %16.0f %16.0f\n", numberOfThreads, rate, rate / numberOfThreads);
+	}
+	printf("\n%s\n", result == 0 ? "All kernels match the scalar decoder" : "MISMATCH between kernels");
+	return result;
+}
@@ -0,0 +1,101 @@
+/*
+ *	Host check of milesTagStats snapshots
+ *
+ *	https://github.com/ncmreynolds/milesTag
+ *
+ *	Released under LGPL-2.1 see https://github.com/ncmreynolds/milesTag/LICENSE for full license
+ *
+ *	Mirrors one set of statistics into another with full and delta snapshots, then checks that truncated and malformed snapshots are refused and leave the mirror untouched
+ *
+ *	build, from the library folder:	g++ -O2 -Isrc extras/hostStatsTest.cpp src/milesTagStats.cpp -o hostStatsTest
+ *
+ *	Exits with 1 if any check fails
+ *
+ */
+#include "milesTagStats.h"
+#include <stdio.h>
+
+uint32_t failures = 0;
+
+void check(const char* name, bool passed)
+{
+	printf("%-60s %s\n", name, passed ? "ok" : "FAILED");
+	failures += passed == false;
+}
+bool same_stats(milesTagStats &a, milesTagStats &b)
+{
+	for(uint8_t index = 0; index < milesTagStats::maximumPlayers; index++)
+	{
+		if(a.hitsTakenFromPlayer(index) != b.hitsTakenFromPlayer(index) || a.damageTakenFromPlayer(index) != b.damageTakenFromPlayer(index) || a.lastHitFromPlayer(index) != b.lastHitFromPlayer(index))
+		{
+			return false;
+		}
+	}
+	for(uint8_t index = 0; index < milesTagStats::maximumTeams; index++)
+	{
+		if(a.hitsTakenFromTeam(index) != b.hitsTakenFromTeam(index) || a.damageTakenFromTeam(index) != b.damageTakenFromTeam(index) || a.lastHitFromTeam(index) != b.lastHitFromTeam(index))
+		{
+			return false;
+		}
+	}
+	for(uint8_t index = 0; index < milesTagStats::maximumTransmitters; index++)
+	{
+		if(a.shotsFired(index) != b.shotsFired(index) || a.lastShot(index) != b.lastShot(index))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+void play(milesTagStats &stats, uint32_t seed, uint32_t &time)			//Some hits and shots
+{
+	for(uint32_t index = 0; index < 50; index++)
+	{
+		uint32_t value = (index + 1) * 2654435761u ^ seed;
+		time += 1000 + value % 5000;
+		stats.recordHit((value >> 8) % 128, (value >> 16) % 4, 1 + (value >> 20) % 100, time);
+		stats.recordShot((value >> 4) % 2, time);
+	}
+}
+int main()
+{
+	milesTagStats player;												//The statistics being mirrored
+	milesTagStats mirror;												//eg. on a game server
+	uint8_t snapshot[1024];
+	uint32_t time = 0;
+	play(player, 1, time);
+	uint16_t length = player.serialiseSnapshot(snapshot, sizeof(snapshot), time);
+	check("Full snapshot applied", mirror.applySnapshot(snapshot, length));
+	check("Mirror matches after a full snapshot", same_stats(player, mirror));
+	play(player, 2, time);
+	length = player.serialiseSnapshot(snapshot, sizeof(snapshot), time);
+	check("Delta snapshot applied", mirror.applySnapshot(snapshot, length));
+	check("Mirror matches after a delta snapshot", same_stats(player, mirror));
+	milesTagStats before = mirror;										//What the mirror must still hold after each refused snapshot
+	play(player, 3, time);
+	length = player.serialiseSnapshot(snapshot, sizeof(snapshot), time);
+	check("Truncated delta snapshot refused", mirror.applySnapshot(snapshot, length - 1) == false);
+	check("Truncated delta snapshot left the mirror untouched", same_stats(mirror, before));
+	length = player.serialiseSnapshot(snapshot, sizeof(snapshot), time, true);
+	bool refused = true;
+	for(uint16_t truncated = milesTagStats::snapshotHeaderLength + 1; truncated < length; truncated++)	//Cut off part way through every record, a whole number of records would be valid
+	{
+		milesTagStats copy = mirror;
+		bool applied = copy.applySnapshot(snapshot, truncated);
+		if(applied == false && same_stats(copy, before) == false)
+		{
+			refused = false;
+		}
+	}
+	check("Truncated full snapshots left the mirror untouched", refused);
+	check("Truncated full snapshot refused", mirror.applySnapshot(snapshot, length - 1) == false);
+	check("Truncated full snapshot did not reset the mirror", same_stats(mirror, before) && mirror.totalHitsTaken() > 0);
+	snapshot[length - 4] = 0x90;										//Unknown record type in the last record
+	check("Malformed full snapshot refused", mirror.applySnapshot(snapshot, length) == false);
+	check("Malformed full snapshot left the mirror untouched", same_stats(mirror, before));
+	length = player.serialiseSnapshot(snapshot, sizeof(snapshot), time, true);
+	check("Valid full snapshot applied after the refused ones", mirror.applySnapshot(snapshot, length));
+	check("Mirror matches after recovering", same_stats(player, mirror));
+	printf("\n%s\n", failures == 0 ? "All checks passed" : "CHECKS FAILED");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#!/bin/sh
+#
+#	Flash, RAM and IRAM use of the example sketches in each feature configuration
+#
+#	Needs arduino-cli with the ESP32 core installed, run from anywhere
+#
+#	usage: extras/sizeReport.sh [fqbn]		default fqbn is esp32:esp32:esp32c3
+#
+#	Each sketch is built from clean with the flags passed to the library as well, as set in compiler.cpp.extra_flags
+#
+#	IRAM is the size of .iram0.text, code that runs with the flash cache disabled, read from the ELF with the core's own size tool. Set SIZE_TOOL to use another, eg. llvm-size
+#
+#	Saved is the flash saved against the same sketch built with no flags, the first row for each sketch, so a flag that stops saving anything shows up as 0
+#
+#	Reference figures, paste a new run over these when the core or the library changes so the next run has something to compare against
+#
+#	Core: not yet recorded, these have not been measured on a machine with the ESP32 core installed
+#	Sketch                     Build flags                                             Flash        RAM       IRAM      Saved
+#	singleTransmitter          (none)                                                      -          -          -          -
+#	singleTransmitter          -DMILESTAG_TRANSMIT_ONLY                                    -          -          -          -
+#	singleTransmitter          -DMILESTAG_TRANSMIT_ONLY -DMILESTAG_NO_DEBUG                -          -          -          -
+#	singleReceiver             (none)                                                      -          -          -          -
+#	singleReceiver             -DMILESTAG_RECEIVE_ONLY                                     -          -          -          -
+#	singleReceiver             -DMILESTAG_RECEIVE_ONLY -DMILESTAG_NO_DEBUG                 -          -          -          -
+#	singleReceiver             -DMILESTAG_FLASH_SAFE_RECEIVE                               -          -          -          -
+#	transmitterReceiverCombo   (none)                                                      -          -          -          -
+#	transmitterReceiverCombo   -DMILESTAG_NO_DEBUG                                         -          -          -          -
+#	transmitterReceiverCombo   -DMILESTAG_FLASH_SAFE_RECEIVE                               -          -          -          -
+#
+fqbn=${1:-esp32:esp32:esp32c3}
+library=$(cd "$(dirname "$0")/.." && pwd)
+examples="$library/examples/Basic"
+build=$(mktemp -d)
+trap 'rm -rf "$build"' EXIT
+size_tool=${SIZE_TOOL:-$(find "${ARDUINO_DATA_DIR:-$HOME/.arduino15}/packages/esp32/tools" -name '*-elf-size' 2>/dev/null | grep -E "$(case "$fqbn" in *esp32c*|*esp32h*|*esp32p*) echo riscv32;; *) echo xtensa;; esac)" | head -n 1)}
+
+report() {	#sketch, flags
+	output=$(arduino-cli compile --clean --fqbn "$fqbn" --library "$library" --build-path "$build/$1" \
+		--build-property "compiler.cpp.extra_flags=$2" "$examples/$1" 2>&1)
+	flash=$(echo "$output" | sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p')
+	ram=$(echo "$output" | sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p')
+	iram=$("${size_tool:-size}" -A "$build/$1/$1.ino.elf" 2>/dev/null | awk '$1 == ".iram0.text" {print $2}')
+	if [ -z "$2" ]; then
+		unflagged=$flash												#What the following rows for this sketch are compared against
+	fi
+	if [ -z "$flash" ]; then
+		printf '%-26s %-50s %10s %10s %10s %10s\n' "$1" "${2:-(none)}" "failed" "-" "-" "-"
+	else
+		printf '%-26s %-50s %10s %10s %10s %10s\n' "$1" "${2:-(none)}" "$flash" "$ram" "${iram:--}" "$([ -n "$unflagged" ] && echo $((unflagged - flash)) || echo -)"
+	fi
+}
+
+echo "milesTag size report for $fqbn, in bytes"
+echo "Core: esp32:esp32 $(arduino-cli core list 2>/dev/null | awk '$1 == "esp32:esp32" {print $2}')"
+printf '%-26s %-50s %10s %10s %10s %10s\n' "Sketch" "Build flags" "Flash" "RAM" "IRAM" "Saved"
+report singleTransmitter ""
+report singleTransmitter "-DMILESTAG_TRANSMIT_ONLY"
+report singleTransmitter "-DMILESTAG_TRANSMIT_ONLY -DMILESTAG_NO_DEBUG"
+report singleReceiver ""
+report singleReceiver "-DMILESTAG_RECEIVE_ONLY"
+report singleReceiver "-DMILESTAG_RECEIVE_ONLY -DMILESTAG_NO_DEBUG"
+report singleReceiver "-DMILESTAG_FLASH_SAFE_RECEIVE"
+report transmitterReceiverCombo ""
+report transmitterReceiverCombo "-DMILESTAG_NO_DEBUG"
+report transmitterReceiverCombo "-DMILESTAG_FLASH_SAFE_RECEIVE"
@@ -10,9 +10,17 @@
 #define milesTag_cpp
 #include "milesTag.h"
 
+const uint8_t MILESTAG_FEATURE_CHECK = 0;	//Referenced by every file including milesTag.h, see there
+
 
 milesTagClass::milesTagClass()	//Constructor function
 {
+	#if defined SUPPORT_RMT_TRANSMIT
+		for(uint8_t index = 0; index < maximumNumberOfTransmitters; index++)
+		{
+			transmitter_carrier_config_[index] = global_transmitter_config_;
+		}
+	#endif
 }
 
 milesTagClass::~milesTagClass()	//Destructor function
@@ -23,9 +31,13 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 	type = typeToIntialise;
 	#if defined SUPPORT_MILESTAG_TRANSMIT
 		number_of_transmitters_ = numberOfTransmitters;
+	#else
+		(void)numberOfTransmitters;
 	#endif
 	#if defined SUPPORT_MILESTAG_RECEIVE
 		number_of_receivers_ = numberOfReceivers;
+	#else
+		(void)numberOfReceivers;
 	#endif
 	bool initialisation_success_ = true;
 	#if defined SUPPORT_MILESTAG_TRANSMIT && defined SUPPORT_MILESTAG_RECEIVE
@@ -44,6 +56,10 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 		}
 	#endif
 	#if defined SUPPORT_MILESTAG_TRANSMIT
+		if(number_of_transmitters_ > maximumNumberOfTransmitters)
+		{
+			initialisation_success_ = false;
+		}
 		if(type == deviceType::transmitter)
 		{
 			#if defined SUPPORT_RMT_TRANSMIT && ESP_IDF_VERSION_MAJOR < 5
@@ -84,14 +100,23 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 	//Possible workaround for RMT initialisation issue following an unexpected reset, eg. during programming
 	//periph_module_disable(PERIPH_RMT_MODULE);
     //periph_module_enable(PERIPH_RMT_MODULE);
+	#if defined ESP32 && defined MILESTAG_FLASH_SAFE_RECEIVE
+		if(debug_uart_ != nullptr)
+		{
+			debug_uart_->println(F("milesTag: RMT callback buffers in internal RAM"));
+		}
+	#endif
 	#if defined SUPPORT_MILESTAG_TRANSMIT
 		if(type == deviceType::transmitter || type == deviceType::combo)
 		{
 			#if defined SUPPORT_RMT_TRANSMIT
-				infrared_transmitter_handle_ = new rmt_channel_handle_t[number_of_transmitters_];
+				infrared_transmitter_handle_ = internal_new_<rmt_channel_handle_t>(number_of_transmitters_);	//Read by the tx done callback
 				infrared_transmitter_config_ = new rmt_tx_channel_config_t[number_of_transmitters_];
 				symbols_to_transmit_ = new rmt_symbol_word_t*[number_of_transmitters_];
-				number_of_symbols_to_transmit_ = new uint8_t[number_of_transmitters_];
+				number_of_symbols_to_transmit_ = internal_new_<uint8_t>(number_of_transmitters_);
+				carrier_switch_time_ = new uint32_t[number_of_transmitters_];
+				sequence_symbols_ = new rmt_symbol_word_t*[number_of_transmitters_];
+				sequence_length_ = new uint8_t[number_of_transmitters_];
 				//encoder = static_cast<milesTagClass::milestag_encoder_t_*>(rmt_alloc_encoder_mem(sizeof(milestag_encoder_t_)));		//Allocate the encoder
 				if(rmt_new_copy_encoder(&copy_encoder_config_, &copy_encoder_) != ESP_OK)	//Initialise the copy encoder
 				{
@@ -110,8 +135,11 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 				}
 				for(uint8_t index = 0; index < number_of_transmitters_; index++)
 				{
-					symbols_to_transmit_[index] = new rmt_symbol_word_t[maximum_number_of_symbols_];
+					symbols_to_transmit_[index] = internal_new_<rmt_symbol_word_t>(maximum_number_of_symbols_);	//Read by the RMT interrupt as it refills the channel
 					number_of_symbols_to_transmit_[index] = 0;
+					carrier_switch_time_[index] = 0;
+					sequence_symbols_[index] = nullptr;
+					sequence_length_[index] = 0;
 				}
 			#else
 			#endif
@@ -127,15 +155,21 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 			#if defined SUPPORT_RMT_RECEIVE
 				//Create RMT data structures for the receive channels (usually just one, but the intention is to support multiples)
 				infrared_receiver_config_ = new rmt_rx_channel_config_t[number_of_receivers_];	//Create data structures
-				infrared_receiver_handle_ = new rmt_channel_handle_t[number_of_receivers_];
-				number_of_received_symbols_ = new uint8_t[number_of_receivers_];
+				infrared_receiver_handle_ = internal_new_<rmt_channel_handle_t>(number_of_receivers_);	//Read by the rx done callback
+				number_of_received_symbols_ = internal_new_<uint8_t>(number_of_receivers_);
 				received_symbols_ = new rmt_symbol_word_t*[number_of_receivers_];
-				message_data_ = new uint8_t*[number_of_receivers_];
+				received_packet_ = new milesTagPacket[number_of_receivers_];
+				#if defined SUPPORT_MILESTAG_TRANSMIT
+					capture_self_echo_ = internal_new_<bool>(number_of_receivers_);	//Written by the rx done callback
+				#endif
 				for(uint8_t index = 0; index < number_of_receivers_; index++)
 				{
-					received_symbols_[index] = new rmt_symbol_word_t[maximum_number_of_symbols_];
+					received_symbols_[index] = internal_new_<rmt_symbol_word_t>(maximum_number_of_symbols_);	//Written by the RMT interrupt
 					number_of_received_symbols_[index] = 0;
-					message_data_[index] = new uint8_t[maximum_message_length_];
+					#if defined SUPPORT_MILESTAG_TRANSMIT
+						capture_self_echo_[index] = false;
+					#endif
+					infrared_receiver_handle_[index] = nullptr;									//Not configured until a pin is set
 				}
 			#else
 			#endif
@@ -148,17 +182,97 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 	return initialisation_success_;
 }
 #if defined SUPPORT_MILESTAG_TRANSMIT
-	void milesTagClass::setCarrierFrequency(uint16_t frequency)	//Must be done before begin(), default is 56000
+	void milesTagClass::setCarrierFrequency(uint16_t frequency, uint8_t transmitterIndex)
 	{
 		#if defined SUPPORT_RMT_TRANSMIT
-			global_transmitter_config_.frequency_hz = frequency;
+			set_carrier_(transmitterIndex, frequency, -1);
 		#endif
 	}
-	void milesTagClass::setDutyCycle(uint8_t duty, uint8_t transmitterIndex)	//Must be done before begin(), default is 50 and very unlikely to change
+	void milesTagClass::setDutyCycle(uint8_t duty, uint8_t transmitterIndex)
 	{
 		#if defined SUPPORT_RMT_TRANSMIT
-			global_transmitter_config_.duty_cycle = float(duty)/100.0;
+			set_carrier_(transmitterIndex, 0, float(duty)/100.0);
+		#endif
+	}
+	bool milesTagClass::setCarrierProfile(carrierProfile profile, uint8_t transmitterIndex)
+	{
+		#if defined SUPPORT_RMT_TRANSMIT
+			static const uint8_t profile_duty_cycle_[] = {50, 25, 10};	//Indexed by carrierProfile. Duty cycle sets the LED's average power and so the range, the frequency stays on the receivers' band pass
+			if(set_carrier_(transmitterIndex, global_transmitter_config_.frequency_hz, float(profile_duty_cycle_[static_cast<uint8_t>(profile)])/100.0) == false)
+			{
+				return false;
+			}
+			if(debug_uart_ != nullptr)
+			{
+				if(transmitterIndex == allTransmitters)
+				{
+					debug_uart_->printf_P(PSTR("milesTag: all transmitters carrier profile %u%% duty cycle from next transmission\r\n"), profile_duty_cycle_[static_cast<uint8_t>(profile)]);
+				}
+				else
+				{
+					debug_uart_->printf_P(PSTR("milesTag: transmitter %u carrier profile %u%% duty cycle from next transmission\r\n"), transmitterIndex, profile_duty_cycle_[static_cast<uint8_t>(profile)]);
+				}
+			}
+			return true;
+		#else
+			return false;
+		#endif
+	}
+	#if defined SUPPORT_RMT_TRANSMIT
+		bool milesTagClass::set_carrier_(uint8_t transmitterIndex, uint32_t frequency, float dutyCycle)	//A frequency of 0 or negative duty cycle leaves that setting as it is
+		{
+			uint8_t number_of_transmitters_available_ = infrared_transmitter_handle_ != nullptr ? number_of_transmitters_ : maximumNumberOfTransmitters;	//Before begin() any transmitter that could exist
+			if(transmitterIndex >= number_of_transmitters_available_ && transmitterIndex != allTransmitters)
+			{
+				return false;
+			}
+			for(uint8_t index = 0; index < number_of_transmitters_available_; index++)
+			{
+				if(index == transmitterIndex || transmitterIndex == allTransmitters)
+				{
+					if(frequency > 0)
+					{
+						transmitter_carrier_config_[index].frequency_hz = frequency;
+					}
+					if(dutyCycle >= 0)
+					{
+						transmitter_carrier_config_[index].duty_cycle = dutyCycle;
+					}
+					carrier_change_pending_ |= 0x01<<index;	//Applied by configure_tx_pin_() if the channel does not exist yet
+				}
+			}
+			return true;
+		}
+	#endif
+	uint16_t milesTagClass::carrierFrequency(uint8_t transmitterIndex)
+	{
+		#if defined SUPPORT_RMT_TRANSMIT
+			if(transmitterIndex < maximumNumberOfTransmitters)
+			{
+				return transmitter_carrier_config_[transmitterIndex].frequency_hz;
+			}
 		#endif
+		return 0;
+	}
+	uint8_t milesTagClass::dutyCycle(uint8_t transmitterIndex)
+	{
+		#if defined SUPPORT_RMT_TRANSMIT
+			if(transmitterIndex < maximumNumberOfTransmitters)
+			{
+				return uint8_t(transmitter_carrier_config_[transmitterIndex].duty_cycle*100 + 0.5);
+			}
+		#endif
+		return 0;
+	}
+	uint32_t milesTagClass::carrierSwitchTime(uint8_t transmitterIndex)
+	{
+		#if defined SUPPORT_RMT_TRANSMIT
+			if(carrier_switch_time_ != nullptr && transmitterIndex < number_of_transmitters_)
+			{
+				return carrier_switch_time_[transmitterIndex];
+			}
+		#endif
+		return 0;
 	}
 	bool milesTagClass::setTransmitPin(int8_t pin)	//Set transmit pin for a single transmitter device
 	{
@@ -183,9 +297,17 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 		}
 		return false;
 	}
-	bool rmt_tx_done_callback(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *user_data)
+	bool IRAM_ATTR milesTagClass::tx_done_callback_(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *user_data)
 	{
-		*(uint8_t *)(user_data) = 0;	//Reset the symbol count, which shows this channel as free
+		milesTagClass* instance_ = static_cast<milesTagClass*>(user_data);
+		for(uint8_t index = 0; index < instance_->number_of_transmitters_; index++)
+		{
+			if(instance_->infrared_transmitter_handle_[index] == channel)
+			{
+				instance_->number_of_symbols_to_transmit_[index] = 0;	//Reset the symbol count, which shows this channel as free
+			}
+		}
+		instance_->last_transmission_end_ = uint32_t(esp_timer_get_time());	//The same clock as micros(), truncated the same way
 		return false;
 	}
 	bool milesTagClass::configure_tx_pin_(uint8_t index, int8_t pin)
@@ -204,15 +326,15 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 		if(rmt_new_tx_channel(&infrared_transmitter_config_[index], &infrared_transmitter_handle_[index]) == ESP_OK)
 		{
 			rmt_tx_event_callbacks_t transmit_callbacks_ = {
-                .on_trans_done = rmt_tx_done_callback
-				//.on_recv_done = tx_done_callback_
+                .on_trans_done = tx_done_callback_
             };
-			rmt_tx_register_event_callbacks(infrared_transmitter_handle_[index], &transmit_callbacks_, &number_of_symbols_to_transmit_[index]);
-			rmt_apply_carrier(infrared_transmitter_handle_[index], &global_transmitter_config_);
+			rmt_tx_register_event_callbacks(infrared_transmitter_handle_[index], &transmit_callbacks_, this);
+			rmt_apply_carrier(infrared_transmitter_handle_[index], &transmitter_carrier_config_[index]);
+			carrier_change_pending_ &= ~(0x01<<index);
 			rmt_enable(infrared_transmitter_handle_[index]);
 			if(debug_uart_ != nullptr)
 			{
-				debug_uart_->printf_P(PSTR("milesTag: configured pin %u as transmitter %u at %.2fKHz %u%% duty cycle\r\n"), pin, index, float(global_transmitter_config_.frequency_hz/1000), uint8_t(global_transmitter_config_.duty_cycle*100));
+				debug_uart_->printf_P(PSTR("milesTag: configured pin %u as transmitter %u at %.2fKHz %u%% duty cycle\r\n"), pin, index, float(transmitter_carrier_config_[index].frequency_hz)/1000.0, uint8_t(transmitter_carrier_config_[index].duty_cycle*100 + 0.5));
 			}
 			return true;
 		}
@@ -225,109 +347,23 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 		}
 		return false;
 	}
-	void milesTagClass::populate_buffer_with_damage_data_(uint8_t index, uint8_t damage)
+	void milesTagClass::apply_pending_carrier_(uint8_t index)
 	{
-		uint8_t dataToSend[2] = {0,0};
-		dataToSend[0] = player_id_ & B01111111;																		//Player ID is in bottom 7 bits of byte 0, the top bit is always zero for damage
-		dataToSend[1] = ((uint8_t)team_id_) << 6;																	//Team ID is in top two bits of byte 1
-		dataToSend[1] = dataToSend[1] | ((map_damage_to_bitmask_(damage)) << 2);									//Damage is in next four bits of byte 1, others are not sent
-		//Add the milesTag 'start' signal to the RMT buffer
-		symbols_to_transmit_[index][0].duration0 = tx_start_on_time_;
-		symbols_to_transmit_[index][0].level0 = 1;
-		symbols_to_transmit_[index][0].duration1 = tx_off_time_;
-		symbols_to_transmit_[index][0].level1 = 0;
-		//Continue filling the buffer after the 'start' signal
-		for(uint8_t bitIndex = 1; bitIndex < 16; bitIndex++)
+		if(carrier_change_pending_ & (0x01<<index))	//Only ever called with the channel idle, the carrier registers can then be changed without stopping the channel
 		{
-			if(bitIndex < maximum_number_of_symbols_)
+			uint32_t switch_start_ = micros();
+			rmt_apply_carrier(infrared_transmitter_handle_[index], &transmitter_carrier_config_[index]);
+			carrier_switch_time_[index] = micros() - switch_start_;
+			carrier_change_pending_ &= ~(0x01<<index);
+			if(debug_uart_ != nullptr)
 			{
-				if(debug_uart_ != nullptr)
-				{
-				  debug_uart_->printf_P(PSTR("milesTag: byte:%u Bit:%u - "), (bitIndex - 1)/8, (bitIndex - 1)%8);
-				}
-				if(bitRead(dataToSend[(bitIndex - 1)/8], 7-((bitIndex - 1)%8)))
-				{
-					if(debug_uart_ != nullptr)
-					{
-					  debug_uart_->print(F("1\r\n"));
-					}
-					symbols_to_transmit_[index][bitIndex].duration0 = tx_one_on_time_;
-					symbols_to_transmit_[index][bitIndex].level0 = 1;
-					symbols_to_transmit_[index][bitIndex].duration1 = tx_off_time_;
-					symbols_to_transmit_[index][bitIndex].level1 = 0;
-				}
-				else
-				{
-					if(debug_uart_ != nullptr)
-					{
-					  debug_uart_->print(F("0\r\n"));
-					}
-					symbols_to_transmit_[index][bitIndex].duration0 = tx_zero_on_time_;
-					symbols_to_transmit_[index][bitIndex].level0 = 1;
-					symbols_to_transmit_[index][bitIndex].duration1 = tx_off_time_;
-					symbols_to_transmit_[index][bitIndex].level1 = 0;
-				}
+				debug_uart_->printf_P(PSTR("milesTag: transmitter %u carrier changed to %.2fKHz %u%% duty cycle in %u microseconds\r\n"), index, float(transmitter_carrier_config_[index].frequency_hz)/1000.0, uint8_t(transmitter_carrier_config_[index].duty_cycle*100 + 0.5), carrier_switch_time_[index]);
 			}
 		}
-		number_of_symbols_to_transmit_[index] = 15;
-	}
-	uint8_t milesTagClass::map_damage_to_bitmask_(uint8_t damage)
-	{
-		switch(damage)
-		{
-			case 0 ... 1:
-				return B00000000;
-				break;
-			case 2 ... 3:
-				return B00000001;
-				break;
-			case 4:
-				return B00000010;
-				break;
-			case 5 ... 6:
-				return B00000011;
-				break;
-			case 7 ... 9:
-				return B00000100;
-				break;
-			case 10 ... 14:
-				return B00000101;
-				break;
-			case 15 ... 16:
-				return B00000110;
-				break;
-			case 17 ... 19:
-				return B00000111;
-				break;
-			case 20 ... 24:
-				return B00001000;
-				break;
-			case 25 ... 29:
-				return B00001001;
-				break;
-			case 30 ... 34:
-				return B00001010;
-				break;
-			case 35 ... 39:
-				return B00001011;
-				break;
-			case 40 ... 49:
-				return B00001100;
-				break;
-			case 50 ... 74:
-				return B00001101;
-				break;
-			case 75 ... 99:
-				return B00001110;
-				break;
-			case 100:
-				return B00001111;
-				break;
-			default:
-				return B00000000;
-				break;
-		}
-		return B00000000;
+	}
+	void milesTagClass::populate_buffer_with_damage_data_(uint8_t index, uint8_t damage)
+	{
+		number_of_symbols_to_transmit_[index] = milesTagEncoder::encodeDamage(player_id_, team_id_, damage, reinterpret_cast<milesTagSymbol*>(symbols_to_transmit_[index]), maximum_number_of_symbols_);	//RMT symbols share the encoder's layout
 	}
 	bool milesTagClass::transmit_stored_buffer_(uint8_t transmitterIndex, rmt_symbol_word_t* buffer, uint8_t bufferLength, bool wait)	//Transmit a buffer from the specified transmitter channel
 	{
@@ -339,13 +375,19 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 				debug_uart_->printf_P(PSTR("milesTag: symbol %02u - %s:%04u/%s:%04u\r\n"), index, (buffer[index].level0 == 0 ? "Off":"On"), buffer[index].duration0, (buffer[index].level1 == 0 ? "Off":"On"), buffer[index].duration1);
 			}
 		}
+		apply_pending_carrier_(transmitterIndex);
 		uint32_t sendStart = micros();
+		if(transmitter_active_(transmitterIndex) == false)
+		{
+			last_transmission_start_ = sendStart;
+		}
 		esp_err_t result = rmt_transmit(infrared_transmitter_handle_[transmitterIndex], copy_encoder_, buffer, bufferLength*sizeof(rmt_symbol_word_t), &event_transmitter_config_);	
 		if(wait == true)	//Block until transmitted
 		{
 			rmt_tx_wait_all_done(infrared_transmitter_handle_[transmitterIndex], 1000);
 		}
 		uint32_t sendEnd = micros();
+		last_queue_time_ = sendEnd - sendStart;
 		if(result == ESP_OK)
 		{
 			if(debug_uart_ != nullptr)
@@ -371,7 +413,7 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 			{
 				if(debug_uart_ != nullptr)
 				{
-					debug_uart_->printf_P(PSTR("milesTag: sending damage:%u player ID:%u team ID:%u transmitter:%u\r\n"), map_bitmask_to_damage_(map_damage_to_bitmask_(damage)), player_id_, team_id_, transmitterIndex);
+					debug_uart_->printf_P(PSTR("milesTag: sending damage:%u player ID:%u team ID:%u transmitter:%u\r\n"), damage, player_id_, team_id_, transmitterIndex);
 				}
 				populate_buffer_with_damage_data_(transmitterIndex, damage);
 				return transmit_stored_buffer_(transmitterIndex, symbols_to_transmit_[transmitterIndex], number_of_symbols_to_transmit_[transmitterIndex], wait);
@@ -393,6 +435,242 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 		}
 		return false;
 	}
+	bool milesTagClass::startSequence(uint8_t transmitterIndex)
+	{
+		if(transmitters_configured_ == false || transmitterIndex >= number_of_transmitters_ || number_of_symbols_to_transmit_[transmitterIndex] > 0)
+		{
+			return false;	//A busy transmitter may be sending the old sequence
+		}
+		if(sequence_symbols_[transmitterIndex] == nullptr)
+		{
+			sequence_symbols_[transmitterIndex] = internal_new_<rmt_symbol_word_t>(maximumSequenceSymbols);
+		}
+		sequence_length_[transmitterIndex] = 0;
+		return true;
+	}
+	bool milesTagClass::addDamageToSequence(uint8_t damage, uint32_t gap, uint8_t transmitterIndex)
+	{
+		uint8_t data_[MILESTAG_PROFILE::maximumMessageLength] = {0};
+		milesTagEncoder::packDamage(player_id_, team_id_, damage, data_);
+		return add_to_sequence_(data_, milesTagEncoder::damagePacketBits, gap, transmitterIndex);
+	}
+	bool milesTagClass::addPacketToSequence(const uint8_t* data, uint8_t numberOfBits, uint32_t gap, uint8_t transmitterIndex)
+	{
+		return add_to_sequence_(data, numberOfBits, gap, transmitterIndex);
+	}
+	bool milesTagClass::add_to_sequence_(const uint8_t* data, uint8_t numberOfBits, uint32_t gap, uint8_t transmitterIndex)
+	{
+		if(transmitterIndex >= number_of_transmitters_ || sequence_symbols_ == nullptr || sequence_symbols_[transmitterIndex] == nullptr || number_of_symbols_to_transmit_[transmitterIndex] > 0)
+		{
+			return false;
+		}
+		milesTagSymbol* symbols_ = reinterpret_cast<milesTagSymbol*>(sequence_symbols_[transmitterIndex]);
+		uint8_t length_ = sequence_length_[transmitterIndex];
+		uint16_t previous_gap_ = length_ > 0 ? symbols_[length_ - 1].duration1 : 0;	//The end of the last packet, appendGap() changes it
+		if(length_ > 0)
+		{
+			length_ = milesTagEncoder::appendGap(gap < MILESTAG_PROFILE::offTime ? MILESTAG_PROFILE::offTime : gap, symbols_, length_, maximumSequenceSymbols);
+			if(length_ == 0)
+			{
+				return false;
+			}
+		}
+		uint8_t added_ = milesTagEncoder::encodePacket(data, numberOfBits, &symbols_[length_], maximumSequenceSymbols - length_);
+		if(added_ == 0)
+		{
+			if(sequence_length_[transmitterIndex] > 0)
+			{
+				symbols_[sequence_length_[transmitterIndex] - 1].duration1 = previous_gap_;	//Put back the end of the last packet
+			}
+			return false;
+		}
+		sequence_length_[transmitterIndex] = length_ + added_;
+		return true;
+	}
+	bool milesTagClass::transmitSequence(uint8_t transmitterIndex, bool wait)
+	{
+		if(transmitterIndex >= number_of_transmitters_ || sequence_length_ == nullptr || sequence_length_[transmitterIndex] == 0)
+		{
+			return false;
+		}
+		if(number_of_symbols_to_transmit_[transmitterIndex] > 0)
+		{
+			if(debug_uart_ != nullptr)
+			{
+				debug_uart_->printf_P(PSTR("milesTag: transmitter %u busy\r\n"), transmitterIndex);
+			}
+			return false;
+		}
+		number_of_symbols_to_transmit_[transmitterIndex] = sequence_length_[transmitterIndex];	//Marks the transmitter busy until the whole sequence is sent
+		if(transmit_stored_buffer_(transmitterIndex, sequence_symbols_[transmitterIndex], sequence_length_[transmitterIndex], wait) == false)
+		{
+			number_of_symbols_to_transmit_[transmitterIndex] = 0;
+			return false;
+		}
+		return true;
+	}
+	uint32_t milesTagClass::sequenceDuration(uint8_t transmitterIndex)
+	{
+		if(transmitterIndex >= number_of_transmitters_ || sequence_length_ == nullptr)
+		{
+			return 0;
+		}
+		return milesTagEncoder::duration(reinterpret_cast<milesTagSymbol*>(sequence_symbols_[transmitterIndex]), sequence_length_[transmitterIndex]);
+	}
+	bool milesTagClass::queueDamage(uint8_t damage, transmitPriority priority, uint32_t maximumDelay, uint8_t transmitterMask)
+	{
+		uint8_t data_[MILESTAG_PROFILE::maximumMessageLength] = {0};
+		milesTagEncoder::packDamage(player_id_, team_id_, damage, data_);
+		return queuePacket(data_, milesTagEncoder::damagePacketBits, priority, maximumDelay, transmitterMask);
+	}
+	bool milesTagClass::queuePacket(const uint8_t* data, uint8_t numberOfBits, transmitPriority priority, uint32_t maximumDelay, uint8_t transmitterMask)
+	{
+		uint8_t priority_ = static_cast<uint8_t>(priority);
+		if(priority_ >= numberOfPriorities || numberOfBits == 0 || numberOfBits > MILESTAG_PROFILE::maximumMessageLength * 8)
+		{
+			return false;
+		}
+		milesTagQueueStats &stats_ = transmit_queue_stats_[priority_];
+		if((transmitterMask & configured_transmitter_mask_()) == 0)	//It would never be sent and would block everything queued behind it
+		{
+			stats_.droppedNoTransmitter++;
+			if(debug_uart_ != nullptr)
+			{
+				debug_uart_->printf_P(PSTR("milesTag: no transmitter in mask %02x\r\n"), transmitterMask);
+			}
+			return false;
+		}
+		if(stats_.depth == transmitQueueLength)
+		{
+			stats_.droppedFull++;
+			if(debug_uart_ != nullptr)
+			{
+				debug_uart_->printf_P(PSTR("milesTag: priority %u transmit queue full\r\n"), priority_);
+			}
+			return false;
+		}
+		queued_packet_t_ &entry_ = transmit_queue_[priority_][(transmit_queue_head_[priority_] + stats_.depth) % transmitQueueLength];
+		memcpy(entry_.data, data, (numberOfBits + 7)/8);
+		entry_.numberOfBits = numberOfBits;
+		entry_.transmitterMask = transmitterMask;
+		entry_.queuedAt = micros();
+		entry_.maximumDelay = maximumDelay;
+		stats_.depth++;
+		if(stats_.depth > stats_.maximumDepth)
+		{
+			stats_.maximumDepth = stats_.depth;
+		}
+		serviceTransmitQueue();	//Send it straight away if a transmitter is free
+		return true;
+	}
+	uint8_t milesTagClass::serviceTransmitQueue()
+	{
+		uint8_t sent_ = 0;
+		if(transmitters_configured_ == false)
+		{
+			return sent_;
+		}
+		for(uint8_t priority_ = 0; priority_ < numberOfPriorities; priority_++)	//Highest priority first
+		{
+			milesTagQueueStats &stats_ = transmit_queue_stats_[priority_];
+			while(stats_.depth > 0)
+			{
+				queued_packet_t_ &entry_ = transmit_queue_[priority_][transmit_queue_head_[priority_]];
+				uint32_t latency_ = micros() - entry_.queuedAt;
+				if((entry_.transmitterMask & configured_transmitter_mask_()) == 0)	//No transmitter can ever send it, waiting would block the queue for good
+				{
+					stats_.droppedNoTransmitter++;
+					if(debug_uart_ != nullptr)
+					{
+						debug_uart_->printf_P(PSTR("milesTag: dropped priority %u packet, no transmitter in mask %02x\r\n"), priority_, entry_.transmitterMask);
+					}
+				}
+				else if(entry_.maximumDelay > 0 && latency_ > entry_.maximumDelay)	//Too late, sending it now would do more harm than good
+				{
+					stats_.droppedLate++;
+					if(debug_uart_ != nullptr)
+					{
+						debug_uart_->printf_P(PSTR("milesTag: dropped priority %u packet %u microseconds late\r\n"), priority_, latency_ - entry_.maximumDelay);
+					}
+				}
+				else
+				{
+					int8_t transmitter_ = free_transmitter_(entry_.transmitterMask);
+					if(transmitter_ < 0)
+					{
+						break;	//Nothing free for this packet, a lower priority one may be able to use a different transmitter
+					}
+					number_of_symbols_to_transmit_[transmitter_] = milesTagEncoder::encodePacket(entry_.data, entry_.numberOfBits, reinterpret_cast<milesTagSymbol*>(symbols_to_transmit_[transmitter_]), maximum_number_of_symbols_);
+					if(transmit_stored_buffer_(transmitter_, symbols_to_transmit_[transmitter_], number_of_symbols_to_transmit_[transmitter_]) == true)
+					{
+						stats_.sent++;
+						transmit_queue_total_latency_[priority_] += latency_;
+						stats_.meanLatency = transmit_queue_total_latency_[priority_] / stats_.sent;
+						if(latency_ > stats_.worstLatency)
+						{
+							stats_.worstLatency = latency_;
+						}
+						sent_++;
+					}
+					else
+					{
+						number_of_symbols_to_transmit_[transmitter_] = 0;	//Nothing was queued in the RMT so the channel is still free
+						break;
+					}
+				}
+				transmit_queue_head_[priority_] = (transmit_queue_head_[priority_] + 1) % transmitQueueLength;
+				stats_.depth--;
+			}
+		}
+		return sent_;
+	}
+	bool IRAM_ATTR milesTagClass::transmitter_active_(uint8_t excludedIndex)	//Also used by the rx done callback
+	{
+		for(uint8_t index = 0; index < number_of_transmitters_; index++)
+		{
+			if(index != excludedIndex && number_of_symbols_to_transmit_[index] > 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+	int8_t milesTagClass::free_transmitter_(uint8_t transmitterMask)
+	{
+		for(uint8_t offset_ = 0; offset_ < number_of_transmitters_; offset_++)
+		{
+			uint8_t index = (next_transmitter_ + offset_) % number_of_transmitters_;
+			if((transmitterMask & (0x01<<index)) && number_of_symbols_to_transmit_[index] == 0)
+			{
+				next_transmitter_ = (index + 1) % number_of_transmitters_;
+				return index;
+			}
+		}
+		return -1;
+	}
+	uint8_t milesTagClass::configured_transmitter_mask_()
+	{
+		return (1u << number_of_transmitters_) - 1;
+	}
+	milesTagQueueStats milesTagClass::transmitQueueStats(transmitPriority priority)
+	{
+		if(static_cast<uint8_t>(priority) >= numberOfPriorities)
+		{
+			return milesTagQueueStats();
+		}
+		return transmit_queue_stats_[static_cast<uint8_t>(priority)];
+	}
+	void milesTagClass::resetTransmitQueueStats()
+	{
+		for(uint8_t priority_ = 0; priority_ < numberOfPriorities; priority_++)
+		{
+			uint8_t depth_ = transmit_queue_stats_[priority_].depth;	//Still queued, so not a statistic to reset
+			transmit_queue_stats_[priority_] = milesTagQueueStats();
+			transmit_queue_stats_[priority_].depth = depth_;
+			transmit_queue_stats_[priority_].maximumDepth = depth_;
+			transmit_queue_total_latency_[priority_] = 0;
+		}
+	}
 #endif
 #if defined SUPPORT_MILESTAG_RECEIVE
 	bool milesTagClass::setReceivePin(int8_t pin, bool inverted)	//Set receive pin for a single transmitter device
@@ -417,21 +695,191 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 		}
 		return false;
 	}
-	bool rmt_rx_done_callback(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *edata, void *user_data)
+	void milesTagClass::setGlitchFilter(uint16_t minimumPulse, uint16_t minimumGap)
 	{
-		//milesTag.ir_data_received_ = true;
-		*(uint8_t *)(user_data) = edata->num_symbols;
-		return false;
+		glitch_filter_minimum_pulse_ = minimumPulse;
+		glitch_filter_minimum_gap_ = minimumGap;
 	}
-	/*
-	bool milesTagClass::rx_done_callback_(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *edata, void *user_data)
+	#if defined SUPPORT_MILESTAG_TRANSMIT
+		void milesTagClass::setSelfTransmissionGating(uint16_t guardTime, uint8_t receiverMask, bool discard)
+		{
+			self_echo_guard_time_ = guardTime;
+			self_echo_gate_mask_ = receiverMask;
+			self_echo_discard_ = discard;
+		}
+		bool milesTagClass::receivedSelfEcho()
+		{
+			return received_self_echo_;
+		}
+		uint32_t milesTagClass::suppressedSelfEchoes()
+		{
+			return suppressed_self_echoes_;
+		}
+		milesTagBenchmarkResult milesTagClass::loopbackBenchmark(uint16_t numberOfPackets, uint8_t transmitterIndex, uint8_t receiverIndex, uint32_t timeout)
+		{
+			milesTagBenchmarkResult result_;
+			if(type != deviceType::combo || transmitters_configured_ == false || transmitterIndex >= number_of_transmitters_ || receiverIndex >= number_of_receivers_ || numberOfPackets == 0)
+			{
+				return result_;
+			}
+			if(numberOfPackets > maximumBenchmarkPackets)
+			{
+				numberOfPackets = maximumBenchmarkPackets;
+			}
+			uint32_t* send_time_ = new uint32_t[numberOfPackets];
+			uint32_t* latency_ = new uint32_t[numberOfPackets];
+			//Everything the benchmark changes is put back afterwards
+			uint8_t player_id_saved_ = player_id_;
+			uint8_t team_id_saved_ = team_id_;
+			uint8_t self_echo_gate_mask_saved_ = self_echo_gate_mask_;
+			#if !defined MILESTAG_NO_DEBUG
+				Stream* debug_uart_saved_ = debug_uart_;
+				debug_uart_ = nullptr;										//Symbol dumps would swamp the timings
+			#endif
+			self_echo_gate_mask_ = 0;										//The loopback is a self echo
+			result_.simulated = (infrared_receiver_handle_[receiverIndex] == nullptr);
+			resume_reception_(receiverIndex);
+			uint64_t total_queue_time_ = 0;
+			uint16_t queued_ = 0;											//Packets rmt_transmit() accepted, failures are not timed
+			uint16_t in_flight_ = 0xFFFF;									//Sequence number of the packet awaiting reception, one at a time so each gets a clean capture
+			uint8_t in_flight_symbols_ = 0;
+			uint32_t inject_at_ = 0;
+			bool inject_pending_ = false;
+			uint64_t time_limit_ = uint64_t(numberOfPackets) * (uint64_t(timeout) + 1);	//Every packet timing out, so this is only reached if something is stuck, eg. the tx done callback never fires
+			if(time_limit_ > 0x7FFFFFFF)
+			{
+				time_limit_ = 0x7FFFFFFF;
+			}
+			uint32_t start_ = micros();
+			while(result_.sent < numberOfPackets || in_flight_ != 0xFFFF)
+			{
+				if(micros() - start_ > time_limit_)
+				{
+					result_.timedOut = true;
+					if(in_flight_ != 0xFFFF)
+					{
+						result_.lost++;
+					}
+					break;
+				}
+				if(in_flight_ == 0xFFFF && result_.sent < numberOfPackets && number_of_symbols_to_transmit_[transmitterIndex] == 0)
+				{
+					uint16_t sequence_ = result_.sent++;
+					player_id_ = sequence_ & 0x7F;								//The sequence number travels in the player and team IDs
+					team_id_ = (sequence_ >> 7) & 0x03;
+					populate_buffer_with_damage_data_(transmitterIndex, benchmark_damage_);
+					in_flight_symbols_ = number_of_symbols_to_transmit_[transmitterIndex];
+					send_time_[sequence_] = micros();
+					if(transmit_stored_buffer_(transmitterIndex, symbols_to_transmit_[transmitterIndex], in_flight_symbols_) == true)
+					{
+						in_flight_ = sequence_;
+						total_queue_time_ += last_queue_time_;
+						queued_++;
+						inject_pending_ = result_.simulated;
+						inject_at_ = send_time_[sequence_] + milesTagEncoder::duration(reinterpret_cast<milesTagSymbol*>(symbols_to_transmit_[transmitterIndex]), in_flight_symbols_) + MILESTAG_PROFILE::receiveIdleThreshold;
+					}
+					else
+					{
+						number_of_symbols_to_transmit_[transmitterIndex] = 0;
+						result_.lost++;
+					}
+				}
+				if(inject_pending_ == true && in_flight_ != 0xFFFF && int32_t(micros() - inject_at_) >= 0 && number_of_received_symbols_[receiverIndex] == 0)
+				{
+					injectReceivedSymbols(receiverIndex, reinterpret_cast<milesTagSymbol*>(symbols_to_transmit_[transmitterIndex]), in_flight_symbols_);	//The packet as it would have arrived once the RMT saw the idle threshold
+					inject_pending_ = false;
+				}
+				if(number_of_received_symbols_[receiverIndex] > 0)
+				{
+					if(parse_received_symbols_(receiverIndex) == true)
+					{
+						uint32_t decoded_ = micros();
+						uint16_t sequence_ = received_player_id_ | (uint16_t(received_team_id_) << 7);
+						if(sequence_ == in_flight_)
+						{
+							latency_[result_.received++] = decoded_ - send_time_[sequence_];
+							in_flight_ = 0xFFFF;
+						}
+					}
+					resume_reception_(receiverIndex);
+				}
+				if(in_flight_ != 0xFFFF && micros() - send_time_[in_flight_] > timeout)
+				{
+					result_.lost++;
+					in_flight_ = 0xFFFF;
+				}
+			}
+			result_.duration = micros() - start_;
+			//Restore the device
+			player_id_ = player_id_saved_;
+			team_id_ = team_id_saved_;
+			self_echo_gate_mask_ = self_echo_gate_mask_saved_;
+			#if !defined MILESTAG_NO_DEBUG
+				debug_uart_ = debug_uart_saved_;
+			#endif
+			if(result_.received > 0)
+			{
+				for(uint16_t index = 1; index < result_.received; index++)	//Insertion sort, there are at most a few hundred
+				{
+					uint32_t latency = latency_[index];
+					uint16_t position = index;
+					while(position > 0 && latency_[position - 1] > latency)
+					{
+						latency_[position] = latency_[position - 1];
+						position--;
+					}
+					latency_[position] = latency;
+				}
+				result_.minimumLatency = latency_[0];
+				result_.medianLatency = latency_[(result_.received - 1) / 2];
+				result_.percentile90Latency = latency_[((result_.received - 1) * 90) / 100];
+				result_.percentile99Latency = latency_[((result_.received - 1) * 99) / 100];
+				result_.maximumLatency = latency_[result_.received - 1];
+				result_.packetsPerSecond = float(result_.received) * 1e6 / float(result_.duration);
+			}
+			if(queued_ > 0)
+			{
+				result_.meanQueueTime = total_queue_time_ / queued_;
+			}
+			delete[] send_time_;
+			delete[] latency_;
+			if(debug_uart_ != nullptr)
+			{
+				debug_uart_->printf_P(PSTR("milesTag: loopback benchmark %u sent %u received %u lost, latency min:%u median:%u 90%%:%u 99%%:%u max:%u microseconds, %.1f packets/s%s%s\r\n"), result_.sent, result_.received, result_.lost, result_.minimumLatency, result_.medianLatency, result_.percentile90Latency, result_.percentile99Latency, result_.maximumLatency, result_.packetsPerSecond, result_.simulated ? " (simulated link)" : "", result_.timedOut ? " timed out" : "");
+			}
+			return result_;
+		}
+		bool IRAM_ATTR milesTagClass::self_echo_(uint32_t captureTime)	//Called as the capture finishes, so later transmissions cannot change the verdict
+		{
+			if(type != deviceType::combo || number_of_symbols_to_transmit_ == nullptr)
+			{
+				return false;
+			}
+			uint32_t capture_end_ = captureTime - MILESTAG_PROFILE::receiveIdleThreshold;	//When the last pulse ended, the RMT waits for the idle threshold before finishing the capture
+			uint32_t since_start_ = capture_end_ - last_transmission_start_;					//Wrapping arithmetic so micros() rolling over does not matter
+			if(transmitter_active_() == true)
+			{
+				return since_start_ < 0x80000000 ||													//During the current transmission
+					captureTime - last_transmission_end_ <= MILESTAG_PROFILE::receiveIdleThreshold + self_echo_guard_time_;	//or within the guard time of the end of the one before
+			}
+			return since_start_ <= last_transmission_end_ + self_echo_guard_time_ - last_transmission_start_;
+		}
+	#endif
+	bool IRAM_ATTR milesTagClass::rx_done_callback_(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *edata, void *user_data)
 	{
-		milesTag.ir_data_received_ = true;
-		milesTag.len = edata->num_symbols;
-		BaseType_t high_task_wakeup = pdFALSE;
-		return high_task_wakeup == pdTRUE;
+		milesTagClass* instance_ = static_cast<milesTagClass*>(user_data);
+		for(uint8_t index = 0; index < instance_->number_of_receivers_; index++)
+		{
+			if(instance_->infrared_receiver_handle_[index] == channel)
+			{
+				#if defined SUPPORT_MILESTAG_TRANSMIT
+					instance_->capture_self_echo_[index] = instance_->self_echo_(uint32_t(esp_timer_get_time()));
+				#endif
+				instance_->number_of_received_symbols_[index] = edata->num_symbols;	//Set last, a non-zero count is what marks the capture ready
+			}
+		}
+		return false;
 	}
-	*/
 	bool milesTagClass::configure_rx_pin_(uint8_t index, int8_t pin, bool inverted)
 	{
 		infrared_receiver_config_[index] = {
@@ -447,10 +895,9 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 		if(rmt_new_rx_channel(&infrared_receiver_config_[index], &infrared_receiver_handle_[index]) == ESP_OK)
 		{
 			rmt_rx_event_callbacks_t receive_callbacks_ = {
-                .on_recv_done = rmt_rx_done_callback
-				//.on_recv_done = rx_done_callback_
+                .on_recv_done = rx_done_callback_
             };
-			rmt_rx_register_event_callbacks(infrared_receiver_handle_[index], &receive_callbacks_, &number_of_received_symbols_[index]);
+			rmt_rx_register_event_callbacks(infrared_receiver_handle_[index], &receive_callbacks_, this);
 			rmt_enable(infrared_receiver_handle_[index]);
 			rmt_receive(infrared_receiver_handle_[index], received_symbols_[index], maximum_number_of_symbols_*sizeof(rmt_symbol_word_t), &global_receiver_config_);
 			if(debug_uart_ != nullptr)
@@ -474,8 +921,27 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 		{
 			if(number_of_received_symbols_[index] > 0)
 			{
+				#if defined SUPPORT_MILESTAG_TRANSMIT
+					bool echo_ = (self_echo_gate_mask_ & (0x01<<index)) && capture_self_echo_[index];
+					if(echo_ == true)
+					{
+						suppressed_self_echoes_++;
+						if(self_echo_discard_ == true)
+						{
+							if(debug_uart_ != nullptr)
+							{
+								debug_uart_->printf_P(PSTR("milesTag: discarded self echo on channel %u\r\n"), index);
+							}
+							resume_reception_(index);	//Discarded without parsing
+							continue;
+						}
+					}
+				#endif
 				if(parse_received_symbols_(index))
 				{
+					#if defined SUPPORT_MILESTAG_TRANSMIT
+						received_self_echo_ = echo_;
+					#endif
 					return true;				//Valid message, inform application
 				}
 				else
@@ -486,173 +952,59 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 		}
 		return false;
 	}
+	#if defined SUPPORT_RMT_RECEIVE
+		static_assert(sizeof(milesTagSymbol) == sizeof(rmt_symbol_word_t), "milesTagSymbol must match rmt_symbol_word_t");
+	#endif
 	bool milesTagClass::parse_received_symbols_(uint8_t index)
 	{
 		if(debug_uart_ != nullptr)
 		{
-			debug_uart_->printf_P(PSTR("milesTag: received %u symbols on channel %u\r\n"), number_of_received_symbols_[index], index);//index);
+			debug_uart_->printf_P(PSTR("milesTag: received %u symbols on channel %u\r\n"), number_of_received_symbols_[index], index);
+			for(uint8_t symbol_index_ = 0; symbol_index_ < number_of_received_symbols_[index]; symbol_index_++)
+			{
+				debug_uart_->printf_P(PSTR("milesTag: symbol %02u - %s:%04u/%s:%04u\r\n"), symbol_index_, !received_symbols_[index][symbol_index_].level0 ? "Off":"On", received_symbols_[index][symbol_index_].duration0, !received_symbols_[index][symbol_index_].level1 ? "Off":"On", received_symbols_[index][symbol_index_].duration1);
+			}
 		}
-		bool start_received_ = false;
-		uint8_t start_position_ = 0;
-		uint8_t bit_index_ = 0;
-		for(uint8_t i = 0; i < maximum_message_length_; i++)	//Clear out any old message
+		milesTagSymbol* symbols_ = reinterpret_cast<milesTagSymbol*>(received_symbols_[index]);	//RMT symbols share the decoder's layout
+		uint8_t number_of_symbols_ = number_of_received_symbols_[index];							//Kept separately, a non-zero count is what marks the receiver busy
+		milesTagPacket &packet_ = received_packet_[index];
+		bool valid_ = milesTagDecoder::decodeCapture(symbols_, number_of_symbols_, packet_, glitch_filter_minimum_pulse_, glitch_filter_minimum_gap_);
+		if(debug_uart_ != nullptr && number_of_symbols_ != number_of_received_symbols_[index])
 		{
-			message_data_[index][i] = 0;
+			debug_uart_->printf_P(PSTR("milesTag: glitch filter reduced %u symbols to %u\r\n"), number_of_received_symbols_[index], number_of_symbols_);
 		}
-		for(uint16_t symbol_index_=0;symbol_index_<number_of_received_symbols_[index];symbol_index_++)
+		if(valid_ == true)
 		{
-			if(debug_uart_ != nullptr)
-			{
-				debug_uart_->printf("milesTag: symbol %02u - %s:%04u/%s:%04u", symbol_index_,!received_symbols_[index][symbol_index_].level0 ? "Off":"On", received_symbols_[index][symbol_index_].duration0,!received_symbols_[index][symbol_index_].level1 ? "Off":"On", received_symbols_[index][symbol_index_].duration1);
-			}
-			if(debug_uart_ != nullptr)
-			{
-				debug_uart_->print(F(" - "));
-			}
-			if((symbol_index_- start_position_) < maximum_message_length_ * 8)
-			{
-				uint8_t symbol_character_ = characterise_symbol_(index, symbol_index_);
-				if(start_received_ == true)
-				{
-					if(symbol_character_ == 0 || symbol_character_ == 1)
-					{
-						if(debug_uart_ != nullptr)
-						{
-							debug_uart_->printf_P(PSTR("byte %u bit %u "), bit_index_/8, bit_index_%8);
-						}
-					}
-					if(symbol_character_ == 0)
-					{
-						if(debug_uart_ != nullptr)
-						{
-							debug_uart_->println('0');
-						}
-						bit_index_++;
-					}
-					else if(symbol_character_ == 1)
-					{
-						if(debug_uart_ != nullptr)
-						{
-							debug_uart_->println('1');
-						}
-						message_data_[index][bit_index_/8] += 0x01<<(7-bit_index_%8);	//Simply binary maths to fill up the packet which is MSB
-						bit_index_++;
-					}
-					else
-					{
-						if(debug_uart_ != nullptr)
-						{
-							debug_uart_->println(F("invalid"));
-						}
-						return false;	//After start, only 1 & 0 are valid
-					}
-				}
-				else
-				{
-					if(symbol_character_ == 2)	//Start must be received before beginning to parse bits
-					{
-						if(debug_uart_ != nullptr)
-						{
-							debug_uart_->println(F("start"));
-						}
-						if(start_received_ == false)
-						{
-							start_received_ = true;
-							start_position_ = symbol_index_ + 1;
-						}
-						else
-						{
-							return false;	//Multiple starts are invalid
-						}
-					}
-					else if(symbol_character_ == 255)	//Invalid symbols invalidate the whole packet as there is no checksum
-					{
-						if(debug_uart_ != nullptr)
-						{
-							debug_uart_->println(F("unknown"));
-						}
-						return false;
-					}
-				}
-			}
-			else
-			{
-				if(debug_uart_ != nullptr)
-				{
-					debug_uart_->println(F("skipped"));
-				}
-			}
+			received_receiver_index_ = index;
+			received_player_id_ = packet_.playerId;
+			received_team_id_ = packet_.teamId;
+			received_damage_ = packet_.damage;
+			received_quality_ = packet_.quality;
 		}
-		if(start_received_ == true)
+		if(debug_uart_ != nullptr)
 		{
-			if(debug_uart_ != nullptr)
+			if(packet_.status == milesTagDecodeStatus::noStart || packet_.status == milesTagDecodeStatus::invalidSymbol)
 			{
-				debug_uart_->print(F("milesTag: message "));
-				for(uint8_t i = 0; i < maximum_message_length_; i++)
-				{
-					debug_uart_->printf_P(PSTR("%02x "), message_data_[index][i]);
-				}
-				debug_uart_->println();
-				debug_uart_->print(F("milesTag: recevied "));
+				debug_uart_->println(packet_.status == milesTagDecodeStatus::noStart ? F("milesTag: no start symbol") : F("milesTag: invalid symbol"));
 			}
-			if((message_data_[index][0] & 0x80) == 0x80)
+			else
 			{
-				if(debug_uart_ != nullptr)
+				debug_uart_->printf_P(PSTR("milesTag: message %02x %02x %02x "), packet_.data[0], packet_.data[1], packet_.data[2]);
+				if(packet_.status == milesTagDecodeStatus::controlPacket)
 				{
 					debug_uart_->println(F("control packet"));
 				}
-			}
-			else
-			{
-				if(number_of_received_symbols_[index] == 15)
+				else if(packet_.status == milesTagDecodeStatus::wrongLength)
 				{
-					received_player_id_ = message_data_[index][0] & 0b01111111;
-					received_team_id_ = (message_data_[index][1] & 0b11000000)>>6;
-					received_damage_ = map_bitmask_to_damage_((message_data_[index][1] & 0b00111100)>>2);
-					if(debug_uart_ != nullptr)
-					{
-						debug_uart_->printf_P(PSTR("damage:%u player ID:%u team ID:%u\r\n"), received_damage_, received_player_id_, received_team_id_);
-					}
-					return true;
+					debug_uart_->println(F("incorrect number of symbols"));
 				}
 				else
 				{
-					if(debug_uart_ != nullptr)
-					{
-						debug_uart_->println(F("incorrent number of symbols"));
-					}
-				}
-			}
-		}
-		//message_data_[index]
-		return false;
-	}
-	uint8_t milesTagClass::characterise_symbol_(uint8_t index, uint8_t symbol_index_)
-	{
-		if(received_symbols_[index][symbol_index_].level0 == 1 && received_symbols_[index][symbol_index_].level1 == 0)	//It's low/high
-		{
-			if((received_symbols_[index][symbol_index_].duration1 > gap_low_watermark_ &&	//Probably a zero
-				received_symbols_[index][symbol_index_].duration1 < gap_high_watermark_) ||
-				received_symbols_[index][symbol_index_].duration1 == 0)						//End of the packet
-			{
-				if(received_symbols_[index][symbol_index_].duration0 > zero_bit_low_watermark_ &&	//Probably a zero
-					received_symbols_[index][symbol_index_].duration0 < zero_bit_high_watermark_)
-				{
-					return 0;
-				}
-				else if(received_symbols_[index][symbol_index_].duration0 > one_bit_low_watermark_ &&	//Probably a zero
-					received_symbols_[index][symbol_index_].duration0 < one_bit_high_watermark_)
-				{
-					return 1;
-				}
-				else if(received_symbols_[index][symbol_index_].duration0 > start_bit_low_watermark_ &&	//Probably a zero
-					received_symbols_[index][symbol_index_].duration0 < start_bit_high_watermark_)
-				{
-					return 2;
+					debug_uart_->printf_P(PSTR("damage:%u player ID:%u team ID:%u pulse deviation mean:%d worst:%u gap jitter:%u\r\n"), received_damage_, received_player_id_, received_team_id_, packet_.quality.meanPulseDeviation, packet_.quality.worstPulseDeviation, packet_.quality.gapJitter);
 				}
 			}
 		}
-		return 255;
+		return valid_;
 	}
 	uint8_t milesTagClass::receivedDamage()
 	{
@@ -683,68 +1035,42 @@ bool milesTagClass::begin(deviceType typeToIntialise, uint8_t numberOfTransmitte
 		}
 		return false;
 	}
+	milesTagSignalQuality milesTagClass::receivedSignalQuality()
+	{
+		return received_quality_;
+	}
+	uint8_t milesTagClass::receivedReceiverIndex()
+	{
+		return received_receiver_index_;
+	}
+	bool milesTagClass::receiverBusy(uint8_t receiverIndex)
+	{
+		return receiverIndex < number_of_receivers_ && number_of_received_symbols_[receiverIndex] > 0;
+	}
+	bool milesTagClass::injectReceivedSymbols(uint8_t receiverIndex, const milesTagSymbol* symbols, uint8_t numberOfSymbols)
+	{
+		if(received_symbols_ == nullptr || receiverIndex >= number_of_receivers_ || number_of_received_symbols_[receiverIndex] > 0)
+		{
+			return false;	//A real receiver would also miss this, as it only restarts when the application resumes reception
+		}
+		if(numberOfSymbols > maximum_number_of_symbols_)
+		{
+			numberOfSymbols = maximum_number_of_symbols_;	//The RMT buffer would overflow in the same way
+		}
+		memcpy(received_symbols_[receiverIndex], symbols, numberOfSymbols*sizeof(rmt_symbol_word_t));
+		#if defined SUPPORT_MILESTAG_TRANSMIT
+			capture_self_echo_[receiverIndex] = self_echo_(micros() + MILESTAG_PROFILE::receiveIdleThreshold);	//As if the capture had just ended
+		#endif
+		number_of_received_symbols_[receiverIndex] = numberOfSymbols;
+		return true;
+	}
 	void milesTagClass::resume_reception_(uint8_t index)
 	{
 		number_of_received_symbols_[index] = 0;
-		rmt_receive(infrared_receiver_handle_[index], received_symbols_[index], maximum_number_of_symbols_*sizeof(rmt_symbol_word_t), &global_receiver_config_);
-	}
-	uint8_t milesTagClass::map_bitmask_to_damage_(uint8_t bitmask)
-	{
-		switch(bitmask)
-		{
-			case 0:
-				return 1;
-				break;
-			case 1:
-				return 2;
-				break;
-			case 2:
-				return 4;
-				break;
-			case 3:
-				return 5;
-				break;
-			case 4:
-				return 7;
-				break;
-			case 5:
-				return 10;
-				break;
-			case 6:
-				return 15;
-				break;
-			case 7:
-				return 17;
-				break;
-			case 8:
-				return 20;
-				break;
-			case 9:
-				return 25;
-				break;
-			case 10:
-				return 30;
-				break;
-			case 11:
-				return 35;
-				break;
-			case 12:
-				return 40;
-				break;
-			case 13:
-				return 50;
-				break;
-			case 14:
-				return 75;
-				break;
-			case 15:
-				return 100;
-				break;
-			default:
-				return 1;
-				break;
-		}
-		return 1;
+		if(infrared_receiver_handle_[index] != nullptr)	//Receivers fed by injectReceivedSymbols() have no channel
+		{
+			rmt_receive(infrared_receiver_handle_[index], received_symbols_[index], maximum_number_of_symbols_*sizeof(rmt_symbol_word_t), &global_receiver_config_);
+		}
 	}
 #endif
 /*
@@ -771,7 +1097,12 @@ uint8_t milesTagClass::teamId()	//Get the player team ID, which can be 0-3, defa
 }
 void milesTagClass::debug(Stream &terminalStream)
 {
+	#if defined MILESTAG_NO_DEBUG
+		(void)terminalStream;
+		return;
+	#else
 	debug_uart_ = &terminalStream;		//Set the stream used for the terminal
+	#endif
 	#if defined(ESP8266)
 	if(&terminalStream == &Serial)
 	{
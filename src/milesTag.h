@@ -9,11 +9,57 @@
 #ifndef milesTag_h
 #define milesTag_h
 #include <Arduino.h>			//Standard Arduino library
+#include "milesTagDecoder.h"	//Platform independent packet decoder
+#include "milesTagEncoder.h"	//Platform independent packet encoder
 
-#define SUPPORT_MILESTAG_TRANSMIT
-#define SUPPORT_MILESTAG_RECEIVE
+/*
+ *	Features are selected with build flags rather than #defines in a sketch, so the library is compiled with the same selection
+ *
+ *	-DMILESTAG_TRANSMIT_ONLY	drop reception, the decoder and the RMT RX driver, eg. for a plain gun
+ *	-DMILESTAG_RECEIVE_ONLY		drop transmission, the encoder and the RMT TX driver, eg. for a sensor node
+ *	-DMILESTAG_NO_DEBUG			drop all debug output and its strings, debug() does nothing
+ *	-DMILESTAG_FLASH_SAFE_RECEIVE	allocate everything the RMT callbacks touch from internal RAM
+ */
+#if defined MILESTAG_TRANSMIT_ONLY && defined MILESTAG_RECEIVE_ONLY
+	#error "MILESTAG_TRANSMIT_ONLY and MILESTAG_RECEIVE_ONLY cannot both be set"
+#endif
+#if !defined MILESTAG_RECEIVE_ONLY
+	#define SUPPORT_MILESTAG_TRANSMIT
+#endif
+#if !defined MILESTAG_TRANSMIT_ONLY
+	#define SUPPORT_MILESTAG_RECEIVE
+#endif
+#if defined SUPPORT_MILESTAG_TRANSMIT && defined SUPPORT_MILESTAG_RECEIVE	//A sketch built with different flags to the library has a different milesTagClass, this makes it fail to link rather than crash
+	#define MILESTAG_FEATURE_CHECK_FEATURES_ TransmitAndReceive
+#elif defined SUPPORT_MILESTAG_TRANSMIT
+	#define MILESTAG_FEATURE_CHECK_FEATURES_ TransmitOnly
+#else
+	#define MILESTAG_FEATURE_CHECK_FEATURES_ ReceiveOnly
+#endif
+#if defined MILESTAG_NO_DEBUG															//Changes the type of the debug stream
+	#define MILESTAG_FEATURE_CHECK_DEBUG_ _NoDebug
+#else
+	#define MILESTAG_FEATURE_CHECK_DEBUG_
+#endif
+#if defined MILESTAG_FLASH_SAFE_RECEIVE													//Changes how buffers are allocated
+	#define MILESTAG_FEATURE_CHECK_ALLOCATION_ _FlashSafeReceive
+#else
+	#define MILESTAG_FEATURE_CHECK_ALLOCATION_
+#endif
+#define MILESTAG_FEATURE_CHECK_JOIN_(features, debug, allocation) milesTagBuiltFor##features##debug##allocation
+#define MILESTAG_FEATURE_CHECK_NAME_(features, debug, allocation) MILESTAG_FEATURE_CHECK_JOIN_(features, debug, allocation)	//Expands the arguments before they are joined
+#define MILESTAG_FEATURE_CHECK MILESTAG_FEATURE_CHECK_NAME_(MILESTAG_FEATURE_CHECK_FEATURES_, MILESTAG_FEATURE_CHECK_DEBUG_, MILESTAG_FEATURE_CHECK_ALLOCATION_)	//eg. milesTagBuiltForTransmitOnly_NoDebug
+extern const uint8_t MILESTAG_FEATURE_CHECK;
+static const uint8_t* const milesTagFeatureCheck __attribute__((used)) = &MILESTAG_FEATURE_CHECK;
 
 #if defined ESP32						//Use the RMT peripheral for ESP32
+	#include "esp_timer.h"					//esp_timer_get_time() is in IRAM, unlike micros(), so the RMT callbacks use it
+	#if defined MILESTAG_FLASH_SAFE_RECEIVE	//Build flag, allocate everything the RMT callbacks touch from internal RAM rather than PSRAM. The RMT driver's own interrupt also needs CONFIG_RMT_ISR_IRAM_SAFE to run during flash writes
+		#include "esp_heap_caps.h"
+		#if !defined CONFIG_RMT_ISR_IRAM_SAFE
+			#warning "CONFIG_RMT_ISR_IRAM_SAFE is not set in this core, RMT interrupts are deferred until flash operations finish, captures that fit in RMT memory are held until then"
+		#endif
+	#endif
 	#if defined SUPPORT_MILESTAG_TRANSMIT
 		#define SUPPORT_RMT_TRANSMIT
 		#include "driver/rmt_tx.h"
@@ -26,6 +72,33 @@
 
 void recvIR(void* param);
 
+struct milesTagQueueStats {													//Transmit queue statistics for one priority
+	uint8_t depth = 0;														//Packets waiting now
+	uint8_t maximumDepth = 0;												//Most packets ever waiting at once
+	uint32_t sent = 0;														//Packets handed to a transmitter
+	uint32_t droppedLate = 0;												//Packets dropped because they passed their deadline before a transmitter was free
+	uint32_t droppedFull = 0;												//Packets refused because the queue was full
+	uint32_t droppedNoTransmitter = 0;										//Packets refused or dropped because no configured transmitter is in their mask
+	uint32_t meanLatency = 0;												//Time from queueing to transmission, in microseconds
+	uint32_t worstLatency = 0;
+};
+
+struct milesTagBenchmarkResult {												//Loopback benchmark results, latencies are from starting a transmission to the packet being decoded, in microseconds
+	uint16_t sent = 0;
+	uint16_t received = 0;
+	uint16_t lost = 0;														//Not decoded within the timeout
+	uint32_t minimumLatency = 0;
+	uint32_t medianLatency = 0;
+	uint32_t percentile90Latency = 0;
+	uint32_t percentile99Latency = 0;
+	uint32_t maximumLatency = 0;
+	uint32_t meanQueueTime = 0;												//Time spent in rmt_transmit() queueing each packet it accepted
+	uint32_t duration = 0;													//Length of the whole run
+	float packetsPerSecond = 0;												//Packets received per second of the run
+	bool simulated = false;													//The receiver had no pin so the link was simulated
+	bool timedOut = false;													//Stopped after numberOfPackets * timeout without sending everything, eg. the transmitter never finished
+};
+
 class milesTagClass	{
 
 	public:
@@ -35,9 +108,56 @@ class milesTagClass	{
 		static const deviceType transmitter = deviceType::transmitter;			//Convenience kludge for Arduino people
 		static const deviceType receiver = deviceType::receiver;
 		static const deviceType combo = deviceType::combo;
+		enum class carrierProfile{longRange, mediumRange, shortRange};			//Named carrier settings, all at the protocol carrier frequency so receivers see no difference in tuning
+		static const carrierProfile longRange = carrierProfile::longRange;		//50% duty cycle, the default
+		static const carrierProfile mediumRange = carrierProfile::mediumRange;	//25% duty cycle
+		static const carrierProfile shortRange = carrierProfile::shortRange;	//10% duty cycle, for close quarters or snipers in 'pistol' mode
+		enum class transmitPriority{high, normal, low};							//Queued packets are always sent highest priority first
+		static const transmitPriority highPriority = transmitPriority::high;	//eg. respawn or admin packets
+		static const transmitPriority normalPriority = transmitPriority::normal;
+		static const transmitPriority lowPriority = transmitPriority::low;
+		static const uint8_t numberOfPriorities = 3;
+		static const uint8_t transmitQueueLength = 8;							//Per priority
+		static const uint8_t anyTransmitter = 0xFF;								//Transmitter mask to let the scheduler use any free transmitter
+		static const uint8_t allTransmitters = 0xFF;							//Transmitter index to change the carrier of every transmitter at once
+		static const uint8_t maximumNumberOfTransmitters = 8;					//Masks and the carrier table have one entry per transmitter
 		#if defined SUPPORT_MILESTAG_TRANSMIT
-			void setCarrierFrequency(uint16_t frequency);							//Must be done before begin(), default is 56000
-			void setDutyCycle(uint8_t duty, uint8_t transmitterIndex = 0);			//Must be done before begin(), default is 50 and very unlikely to change
+			void setCarrierFrequency(uint16_t frequency,							//Set the carrier of every transmitter, or just one, before or after begin(). Default is 56000 or whatever the protocol profile sets
+				uint8_t transmitterIndex = allTransmitters);
+			void setDutyCycle(uint8_t duty,											//Set the duty cycle of every transmitter, or just one, before or after begin(). Default is 50
+				uint8_t transmitterIndex = allTransmitters);
+			uint16_t carrierFrequency(uint8_t transmitterIndex = 0);				//Carrier frequency a transmitter is set to, 0 if there is no such transmitter
+			uint8_t dutyCycle(uint8_t transmitterIndex = 0);						//Duty cycle a transmitter is set to, 0 if there is no such transmitter
+			bool setCarrierProfile(carrierProfile profile,							//Change a transmitter, or all of them, to a named carrier profile, this takes effect at its next transmission. False if there is no such transmitter
+				uint8_t transmitterIndex = 0);
+			uint32_t carrierSwitchTime(uint8_t transmitterIndex = 0);				//Time taken to apply the last carrier change on a transmitter, in microseconds
+			//Scheduled transmission
+			bool queueDamage(uint8_t damage = 1,									//Queue damage to be sent on the first free transmitter in the mask. False if the queue for this priority is full
+				transmitPriority priority = transmitPriority::normal,
+				uint32_t maximumDelay = 0,											//Drop the packet if it cannot be sent within this many microseconds, 0 waits indefinitely
+				uint8_t transmitterMask = anyTransmitter);							//Bit per transmitter that may send it
+			bool queuePacket(const uint8_t* data,									//Queue an arbitrary packet of up to 24 bits, MSB first, eg. a control message
+				uint8_t numberOfBits,
+				transmitPriority priority = transmitPriority::high,
+				uint32_t maximumDelay = 0,
+				uint8_t transmitterMask = anyTransmitter);
+			//Sequences, several packets sent as one RMT transaction so the hardware times the gaps between them
+			bool startSequence(uint8_t transmitterIndex = 0);						//Start building a new sequence for a transmitter, false if it is busy
+			bool addDamageToSequence(uint8_t damage = 1,							//Add damage to the sequence, false if it does not fit
+				uint32_t gap = defaultSequenceGap,									//Silence before this packet in microseconds, ignored for the first packet
+				uint8_t transmitterIndex = 0);
+			bool addPacketToSequence(const uint8_t* data,							//Add an arbitrary packet of up to 24 bits, MSB first
+				uint8_t numberOfBits,
+				uint32_t gap = defaultSequenceGap,
+				uint8_t transmitterIndex = 0);
+			bool transmitSequence(uint8_t transmitterIndex = 0,						//Send the sequence, it can be sent again later without rebuilding it
+				bool wait = false);
+			uint32_t sequenceDuration(uint8_t transmitterIndex = 0);				//Length of the sequence in microseconds
+			static const uint32_t defaultSequenceGap = MILESTAG_PROFILE::receiveIdleThreshold + MILESTAG_PROFILE::offTime;	//Long enough for receivers to see separate packets
+			static const uint8_t maximumSequenceSymbols = 128;						//About eight damage packets
+			uint8_t serviceTransmitQueue();											//Send queued packets on any free transmitters and drop late ones, call this often from loop(). Returns the number sent
+			milesTagQueueStats transmitQueueStats(transmitPriority priority);		//Depth, drops and latency for a priority
+			void resetTransmitQueueStats();
 			bool setTransmitPin(int8_t pin);										//Set transmit pin for a single transmitter device
 			bool setTransmitPins(int8_t* pins);										//Set transmit pins for a multi-transmitter device
 			//Transmission
@@ -48,11 +168,31 @@ class milesTagClass	{
 		#if defined SUPPORT_MILESTAG_RECEIVE
 			bool setReceivePin(int8_t pin, bool inverted = true);					//Set receive pin for a single transmitter device
 			bool setReceivePins(int8_t* pins);										//Set receive pins for a multi-receiver device
+			void setGlitchFilter(uint16_t minimumPulse = 200,						//Drop pulses and merge gaps shorter than these (in microseconds) before decoding, 0 disables, default is disabled
+				uint16_t minimumGap = 200);
 			bool dataReceived();													//Check if data has been received
 			uint8_t receivedDamage();												//Amount of damage received, 0 implies a message rather than damage
 			uint8_t receivedPlayerId();												//Received player ID in damage or message
 			uint8_t receivedTeamId();												//Received team ID in damage or message
 			bool resumeReception();													//Resume reception on the first 'busy' channel, false if no channel was busy
+			milesTagSignalQuality receivedSignalQuality();							//Timing quality of the current packet, to monitor link margin per receiver and per opponent
+			uint8_t receivedReceiverIndex();										//Index of the receiver the current packet arrived on
+			bool receiverBusy(uint8_t receiverIndex);								//Check if a receiver is holding a capture and not receiving
+			bool injectReceivedSymbols(uint8_t receiverIndex,						//Place a capture in a receiver's buffer as if the RMT had received it, for simulation. False if the receiver is busy
+				const milesTagSymbol* symbols,
+				uint8_t numberOfSymbols);
+		#endif
+		#if defined SUPPORT_MILESTAG_TRANSMIT && defined SUPPORT_MILESTAG_RECEIVE
+			void setSelfTransmissionGating(uint16_t guardTime = 1000,				//On a combo device treat captures that end while a local transmitter is active, or within guardTime microseconds of it finishing, as echoes of our own shots
+				uint8_t receiverMask = 0xFF,										//Bit per receiver to gate, 0 disables gating, default is disabled
+				bool discard = true);												//Discard echoes before they are parsed, otherwise parse them and flag them with receivedSelfEcho()
+			bool receivedSelfEcho();												//The current packet was captured while we were transmitting
+			uint32_t suppressedSelfEchoes();										//Number of captures discarded or flagged as echoes
+			milesTagBenchmarkResult loopbackBenchmark(uint16_t numberOfPackets = 100,	//Fire packets from a transmitter at a receiver on this combo device and measure the latency and throughput. Blocks until done, or at most numberOfPackets * timeout
+				uint8_t transmitterIndex = 0,
+				uint8_t receiverIndex = 0,											//If this receiver has no pin the link is simulated by injecting each packet as it would have arrived, the transmitter must still be configured as packets are sent with rmt_transmit()
+				uint32_t timeout = 100000);											//Count a packet as lost if it is not decoded within this many microseconds
+			static const uint16_t maximumBenchmarkPackets = 512;					//Packets are numbered with the player and team IDs
 		#endif
 		bool begin(deviceType typeToIntialise = deviceType::transmitter,
 			uint8_t numberOfTransmitters = 1,
@@ -66,7 +206,18 @@ class milesTagClass	{
 		//Debug
 		void debug(Stream &);													//Enable debugging on a stream, eg. Serial, which must already be started
 		//Debug
-		Stream *debug_uart_ = nullptr;											//The stream used for debugging
+		#if defined MILESTAG_NO_DEBUG
+			struct no_debug_stream_t_ {											//Stands in for the stream, every debug message is then in a branch the compiler knows is never taken
+				template<class... T> static size_t print(T...) {return 0;}
+				template<class... T> static size_t println(T...) {return 0;}
+				template<class... T> static size_t printf(T...) {return 0;}
+				template<class... T> static size_t printf_P(T...) {return 0;}
+				template<class... T> static size_t write(T...) {return 0;}
+			};
+			static constexpr no_debug_stream_t_ *debug_uart_ = nullptr;
+		#else
+			Stream *debug_uart_ = nullptr;										//The stream used for debugging
+		#endif
 	protected:
 	private:
 		//Game data
@@ -74,10 +225,6 @@ class milesTagClass	{
 		uint8_t team_id_ = 0;													//Can be 0-3
 		uint8_t current_free_channel_ = 1;
 		uint8_t current_free_memory_block_ = 1;
-		static const uint16_t tx_start_on_time_ = 2400;							//Start on time  ie. how long to send carrier for to indicate a start bit
-		static const uint16_t tx_zero_on_time_ = 600;							//Zero on time ie. how long to send carrier for to indicate a zero bit
-		static const uint16_t tx_one_on_time_ = 1200;							//One on time ie. how long to send carrier for to indicate a one bit
-		static const uint16_t tx_off_time_ = 600;								//Off time ie. how long to leave between bits
 		deviceType type = deviceType::transmitter;								//Type of device, which alters behaviour/setup
 		bool transmitters_configured_ = false;
 		bool receivers_configured_ = false;
@@ -88,8 +235,8 @@ class milesTagClass	{
 			//Global settings
 			uint8_t number_of_transmitters_ = 0;									//Number of transmitter channels, usually 1-2
 			#if defined SUPPORT_RMT_TRANSMIT
-			rmt_carrier_config_t global_transmitter_config_ = {						//Global config across all receivers
-				.frequency_hz = 56000,
+			rmt_carrier_config_t global_transmitter_config_ = {						//Protocol default carrier, each transmitter starts with it
+				.frequency_hz = MILESTAG_PROFILE::carrierFrequency,						//56000 for MilesTag 2
 				.duty_cycle = 0.50,
 				//.flags = {
 				//	.polarity_active_low = 0
@@ -112,15 +259,51 @@ class milesTagClass	{
 			rmt_encoder_t *copy_encoder_;											//We will use a 'copy encoder' and do all encoding ourselves
 			rmt_copy_encoder_config_t copy_encoder_config_ = {};					//The copy encoder supports no configuration, but must exist
 			rmt_channel_handle_t* infrared_transmitter_handle_ = nullptr;			//RMT transmitter channels
+			rmt_carrier_config_t transmitter_carrier_config_[maximumNumberOfTransmitters];	//Carrier for each transmitter, fixed size so it can be set before begin(), starts as a copy of the global config
+			uint8_t carrier_change_pending_ = 0;									//One bit per transmitter, applied at the start of the next transmission so a packet is never sent on a mixed carrier
+			uint32_t* carrier_switch_time_ = nullptr;								//Time taken by the last rmt_apply_carrier() on each transmitter
+			static bool tx_done_callback_(rmt_channel_handle_t channel,				//RMT ISR callback, marks the transmitter free
+				const rmt_tx_done_event_data_t *edata,
+				void *user_data);
 			rmt_tx_channel_config_t* infrared_transmitter_config_ = nullptr;		//The RMT configuration for the transmitter(s)
 			rmt_symbol_word_t** symbols_to_transmit_ = nullptr;						//Symbol buffers
-			uint8_t* number_of_symbols_to_transmit_ = nullptr;
+			volatile uint8_t* number_of_symbols_to_transmit_ = nullptr;				//Also marks the transmitter busy, cleared by the tx done callback
 			#endif
+			//Transmit scheduler, a fixed ring buffer per priority
+			struct queued_packet_t_ {
+				uint8_t data[MILESTAG_PROFILE::maximumMessageLength];				//Packed at queue time and encoded when a transmitter is free
+				uint8_t numberOfBits;
+				uint8_t transmitterMask;
+				uint32_t queuedAt;
+				uint32_t maximumDelay;
+			};
+			queued_packet_t_ transmit_queue_[numberOfPriorities][transmitQueueLength];
+			uint8_t transmit_queue_head_[numberOfPriorities] = {0, 0, 0};
+			milesTagQueueStats transmit_queue_stats_[numberOfPriorities];			//Depth is also the number of entries in each ring buffer
+			uint64_t transmit_queue_total_latency_[numberOfPriorities] = {0, 0, 0};	//For the mean
+			uint8_t next_transmitter_ = 0;											//Where to start looking for a free transmitter, so they share the load
+			int8_t free_transmitter_(uint8_t transmitterMask);						//A configured idle transmitter in the mask, or -1
+			uint8_t configured_transmitter_mask_();									//Bit per transmitter that exists
+			#if defined SUPPORT_RMT_TRANSMIT
+			rmt_symbol_word_t** sequence_symbols_ = nullptr;						//Sequence buffers, only allocated for transmitters that use them
+			#endif
+			uint8_t* sequence_length_ = nullptr;
+			bool add_to_sequence_(const uint8_t* data,								//Encode a packet onto the end of a sequence
+				uint8_t numberOfBits,
+				uint32_t gap,
+				uint8_t transmitterIndex);
+			uint32_t last_queue_time_ = 0;											//Time the last rmt_transmit() call took
+			volatile uint32_t last_transmission_start_ = 0;							//Start of the current or last period when any transmitter was active, read by the rx done callback
+			volatile uint32_t last_transmission_end_ = 0;							//Set by the tx done callback
+			bool transmitter_active_(uint8_t excludedIndex = 0xFF);					//Check if any transmitter is sending
 			bool configure_tx_pin_(uint8_t index, int8_t pin);						//Configure a pin for TX on the current available channel
+			void apply_pending_carrier_(uint8_t index);								//Apply a carrier change, if there is one waiting
+			bool set_carrier_(uint8_t transmitterIndex,								//Change the carrier in the table for one transmitter or allTransmitters, false if there is no such transmitter
+				uint32_t frequency,
+				float dutyCycle);
 			//Damage
 			void populate_buffer_with_damage_data_(uint8_t transmitterIndex,		//Build a simple 'damage' packet for transmission, this includes the preamble
 				uint8_t damage);
-			uint8_t map_damage_to_bitmask_(uint8_t damage);							//Turn a numeric damage value into a bitmask for packing into a packet
 			//Transmission
 			bool transmit_stored_buffer_(uint8_t transmitterIndex,					//Transmit a buffer from the specified transmitter channel
 				rmt_symbol_word_t* buffer,
@@ -133,36 +316,48 @@ class milesTagClass	{
 			#if defined SUPPORT_RMT_RECEIVE
 			rmt_receive_config_t global_receiver_config_ = {						//Global config across all receivers
 				.signal_range_min_ns = 2000,											//Actually 600us but 2us is the smallest acceptable value in the SDK
-				.signal_range_max_ns = 2800000,										//Actually 2400us but allow some margin
+				.signal_range_max_ns = MILESTAG_PROFILE::receiveIdleThreshold * 1000,	//Actually 2400us but allow some margin, 2800us for MilesTag 2
 			};
 			//Receiver RMT data
-			rmt_symbol_word_t** received_symbols_;									//Symbol buffers
-			uint8_t* number_of_received_symbols_ = nullptr;							//Count of symbols in the buffer
+			rmt_symbol_word_t** received_symbols_ = nullptr;								//Symbol buffers
+			volatile uint8_t* number_of_received_symbols_ = nullptr;				//Count of symbols in the buffer, set by the rx done callback
 			rmt_rx_channel_config_t* infrared_receiver_config_ = nullptr;			//The RMT configuration for the receiver(s)
 			rmt_channel_handle_t* infrared_receiver_handle_ = nullptr;				//RMT receiver channels
-			//bool rx_done_callback_(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *edata, void *user_data);
+			static bool rx_done_callback_(rmt_channel_handle_t channel,				//RMT ISR callback, records the number of symbols and when the capture finished
+				const rmt_rx_done_event_data_t *edata,
+				void *user_data);
 			void resume_reception_(uint8_t index);									//Resume reception on a specific channel
 			#endif
 			bool configure_rx_pin_(uint8_t index, int8_t pin, bool inverted = true);//Configure a pin for RX on the current available channel
 			bool parse_received_symbols_(uint8_t index);							//Parse a buffer of pulse timings
-			uint8_t characterise_symbol_(uint8_t index,uint8_t  symbol_index_);		//Parse an individual symbol
-			static const uint8_t maximum_message_length_ = 3;						//Maximum size of a milesTag message
-			static const uint16_t start_bit_low_watermark_ = 2200;
-			static const uint16_t start_bit_high_watermark_ = 2480;
-			static const uint16_t zero_bit_low_watermark_ = 590;
-			static const uint16_t zero_bit_high_watermark_ = 680;
-			static const uint16_t one_bit_low_watermark_ = 1190;
-			static const uint16_t one_bit_high_watermark_ = 1280;
-			static const uint16_t gap_low_watermark_ = 520;
-			static const uint16_t gap_high_watermark_ = 680;
-			uint8_t** message_data_ = nullptr;										//One set of message data per receiver
+			milesTagPacket* received_packet_ = nullptr;								//One decoded packet per receiver
+			uint16_t glitch_filter_minimum_pulse_ = 0;								//Glitch filter thresholds, the RMT cannot filter anything over a few microseconds itself
+			uint16_t glitch_filter_minimum_gap_ = 0;
 			uint8_t received_player_id_ = 0;										//Can be 0-127
 			uint8_t received_team_id_ = 0;											//Can be 0-3
 			uint8_t received_damage_ = 0;											//Can be 1-100 but is derived from a bitmask
-			//Damage
-			uint8_t map_bitmask_to_damage_(uint8_t bitmask);						//Turn a bitmask value into a numeric damage value when unpacking a packet
+			uint8_t received_receiver_index_ = 0;									//Receiver the current packet arrived on
+			milesTagSignalQuality received_quality_;								//Quality of the current packet, copied as decode() overwrites the receiver's packet for every capture
+			#if defined SUPPORT_MILESTAG_TRANSMIT
+				uint8_t self_echo_gate_mask_ = 0;									//Receivers that are gated while transmitting
+				uint16_t self_echo_guard_time_ = 1000;
+				bool self_echo_discard_ = true;
+				bool received_self_echo_ = false;
+				uint32_t suppressed_self_echoes_ = 0;
+				volatile bool* capture_self_echo_ = nullptr;						//Whether each receiver's capture overlapped our own transmission, decided by the rx done callback as it finished
+				bool self_echo_(uint32_t captureTime);								//Check if a capture finishing at this time overlapped our own transmission
+				static const uint8_t benchmark_damage_ = 1;
+			#endif
 		#endif
 		//Utilities
+		template<class T> T* internal_new_(size_t count)						//Allocate memory that interrupts may use, in internal RAM if MILESTAG_FLASH_SAFE_RECEIVE is set
+		{
+			#if defined MILESTAG_FLASH_SAFE_RECEIVE
+				return static_cast<T*>(heap_caps_calloc(count, sizeof(T), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+			#else
+				return new T[count];
+			#endif
+		}
 		//rmt_channel_t index_to_channel_(uint8_t index);							//Maps an integer index to an RMT channel
 		//gpio_num_t int8_t_to_gpio_num_t(int8_t pin);							//Maps an integet pin to a gpio_num_t
 };
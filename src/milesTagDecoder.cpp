@@ -0,0 +1,129 @@
+/*
+ *	An Arduino library for milesTag support
+ *
+ *	https://github.com/ncmreynolds/milesTag
+ *
+ *	Released under LGPL-2.1 see https://github.com/ncmreynolds/milesTag/LICENSE for full license
+ *
+ */
+#ifndef milesTagDecoder_cpp
+#define milesTagDecoder_cpp
+#include "milesTagDecoder.h"
+
+uint8_t milesTagDecoderBase::filterGlitches(milesTagSymbol* symbols, uint8_t numberOfSymbols, uint16_t minimumPulse, uint16_t minimumGap)
+{
+	for(uint8_t symbol_index_ = 0; symbol_index_ < numberOfSymbols; symbol_index_++)
+	{
+		if(symbols[symbol_index_].level0 != 1 || symbols[symbol_index_].level1 != 0)
+		{
+			return numberOfSymbols;	//Only captures made of pulse/gap pairs are filtered
+		}
+	}
+	while(numberOfSymbols > 0)	//Repeatedly remove the shortest pulse or gap under its threshold, so a spike in a gap is not mistaken for the end of a pulse and vice versa
+	{
+		uint16_t shortest_ = 0xFFFF;
+		uint8_t shortest_index_ = 0;
+		bool shortest_is_gap_ = false;
+		for(uint8_t symbol_index_ = 0; symbol_index_ < numberOfSymbols; symbol_index_++)
+		{
+			if(symbols[symbol_index_].duration0 < minimumPulse && symbols[symbol_index_].duration0 < shortest_)
+			{
+				shortest_ = symbols[symbol_index_].duration0;
+				shortest_index_ = symbol_index_;
+				shortest_is_gap_ = false;
+			}
+			if(symbol_index_ + 1 < numberOfSymbols && symbols[symbol_index_].duration1 < minimumGap && symbols[symbol_index_].duration1 < shortest_)	//The last gap is the end of the capture
+			{
+				shortest_ = symbols[symbol_index_].duration1;
+				shortest_index_ = symbol_index_;
+				shortest_is_gap_ = true;
+			}
+		}
+		if(shortest_ == 0xFFFF)
+		{
+			break;	//Nothing left to filter
+		}
+		milesTagSymbol &symbol_ = symbols[shortest_index_];
+		uint8_t removed_index_ = shortest_index_;
+		if(shortest_is_gap_ == true)	//A dropout inside a pulse, join it to the following pulse
+		{
+			uint32_t joined_ = symbol_.duration0 + symbol_.duration1 + symbols[shortest_index_ + 1].duration0;
+			symbol_.duration0 = joined_ < 0x7FFF ? joined_ : 0x7FFF;
+			symbol_.duration1 = symbols[shortest_index_ + 1].duration1;
+			removed_index_ = shortest_index_ + 1;
+		}
+		else if(shortest_index_ > 0)	//A spike inside a gap, fold it into the previous gap
+		{
+			milesTagSymbol &previous_ = symbols[shortest_index_ - 1];
+			if(symbol_.duration1 == 0)
+			{
+				previous_.duration1 = 0;	//The spike was at the end, so the previous symbol now ends the capture
+			}
+			else
+			{
+				uint32_t joined_ = previous_.duration1 + symbol_.duration0 + symbol_.duration1;
+				previous_.duration1 = joined_ < 0x7FFF ? joined_ : 0x7FFF;
+			}
+		}
+		numberOfSymbols--;	//A spike before the first pulse is simply dropped
+		for(uint8_t symbol_index_ = removed_index_; symbol_index_ < numberOfSymbols; symbol_index_++)
+		{
+			symbols[symbol_index_] = symbols[symbol_index_ + 1];
+		}
+	}
+	return numberOfSymbols;
+}
+uint8_t milesTagDecoderBase::bitmaskToDamage(uint8_t bitmask)
+{
+	static const uint8_t damage_[16] = {1, 2, 4, 5, 7, 10, 15, 17, 20, 25, 30, 35, 40, 50, 75, 100};
+	if(bitmask < 16)
+	{
+		return damage_[bitmask];
+	}
+	return 1;
+}
+uint8_t milesTagDecoderBase::kernel_limit_ = 2;
+uint8_t milesTagDecoderBase::simd_level_()
+{
+	static const uint8_t level_ = []() -> uint8_t {
+		#if defined MILESTAG_DECODER_X86
+			__builtin_cpu_init();
+			if(__builtin_cpu_supports("avx2"))
+			{
+				return 2;
+			}
+			if(__builtin_cpu_supports("sse2"))
+			{
+				return 1;
+			}
+		#endif
+		return 0;
+	}();
+	return level_ < kernel_limit_ ? level_ : kernel_limit_;
+}
+const char* milesTagDecoderBase::kernel()
+{
+	static const char* kernels_[3] = {"scalar", "sse2", "avx2"};
+	return kernels_[simd_level_()];
+}
+bool milesTagDecoderBase::setKernel(const char* name)
+{
+	static const char* kernels_[3] = {"scalar", "sse2", "avx2"};
+	for(uint8_t level_ = 0; level_ < 3; level_++)
+	{
+		if(strcmp(name, kernels_[level_]) == 0)
+		{
+			uint8_t previous_limit_ = kernel_limit_;
+			kernel_limit_ = 2;
+			if(simd_level_() < level_)
+			{
+				kernel_limit_ = previous_limit_;	//Not available on this CPU, leave it as it was
+				return false;
+			}
+			kernel_limit_ = level_;
+			return true;
+		}
+	}
+	return false;
+}
+#endif
@@ -0,0 +1,409 @@
+/*
+ *	An Arduino library for milesTag support
+ *
+ *	https://github.com/ncmreynolds/milesTag
+ *
+ *	Released under LGPL-2.1 see https://github.com/ncmreynolds/milesTag/LICENSE for full license
+ *
+ *	Platform independent packet decoder, used by milesTagClass on the ESP32 and usable on its own on a host, eg. a Linux based referee
+ *
+ *	milesTagDecoderT is specialised for a timing profile from milesTagProfile.h, milesTagDecoder is the one for MILESTAG_PROFILE
+ *
+ */
+#ifndef milesTagDecoder_h
+#define milesTagDecoder_h
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "milesTagProfile.h"
+#if (defined __x86_64__ || defined __i386__) && (defined __GNUC__ || defined __clang__)	//SIMD classification is only offered on x86 hosts, the ESP32 uses the scalar code
+	#define MILESTAG_DECODER_X86
+	#include <immintrin.h>
+#endif
+#if !defined ARDUINO																	//Batches are only spread across threads on hosts
+	#define MILESTAG_DECODER_THREADS
+	#include <thread>
+	#include <vector>
+#endif
+
+typedef union {															//Pulse timing pair, same layout as rmt_symbol_word_t so RMT captures can be decoded in place
+	struct {
+		uint32_t duration0 : 15;											//Duration of level0 in microseconds
+		uint32_t level0 : 1;												//Level of the first part of the symbol
+		uint32_t duration1 : 15;											//Duration of level1 in microseconds
+		uint32_t level1 : 1;												//Level of the second part of the symbol
+	};
+	uint32_t val;
+} milesTagSymbol;
+
+enum class milesTagDecodeStatus : uint8_t {ok, noStart, invalidSymbol, controlPacket, wrongLength};	//Result of decoding a single capture
+
+struct milesTagSignalQuality {											//How closely a packet matched the nominal timings, all in microseconds
+	int16_t meanPulseDeviation = 0;											//Mean of (measured - nominal) pulse length, IR receivers usually stretch pulses a little
+	uint16_t worstPulseDeviation = 0;										//Largest difference of any pulse from nominal
+	uint16_t gapJitter = 0;													//Difference between the longest and shortest gap
+	uint8_t numberOfPulses = 0;												//Pulses measured, including the start
+};
+
+struct milesTagPacket {													//A decoded packet
+	milesTagDecodeStatus status = milesTagDecodeStatus::noStart;
+	uint8_t data[3] = {0, 0, 0};											//Raw packet, MSB first
+	uint8_t numberOfBits = 0;												//Number of data bits after the start symbol
+	uint8_t playerId = 0;													//Can be 0-127
+	uint8_t teamId = 0;														//Can be 0-3
+	uint8_t damage = 0;														//Can be 1-100 but is derived from a bitmask
+	milesTagSignalQuality quality;											//Timing quality, filled in for everything except captures with invalid symbols
+};
+
+class milesTagDecoderBase	{													//The parts of the decoder that do not depend on the protocol timings
+
+	public:
+		static const uint8_t start = 2;										//Symbol classifications
+		static const uint8_t zero = 0;
+		static const uint8_t one = 1;
+		static const uint8_t invalid = 255;
+		static uint8_t filterGlitches(milesTagSymbol* symbols,				//Merge gaps shorter than minimumGap and drop pulses shorter than minimumPulse, in place. Returns the new number of symbols
+			uint8_t numberOfSymbols,
+			uint16_t minimumPulse,
+			uint16_t minimumGap);
+		static uint8_t bitmaskToDamage(uint8_t bitmask);					//Turn a bitmask value into a numeric damage value when unpacking a packet
+		static const char* kernel();										//Name of the classification kernel in use, eg. "avx2"
+		static bool setKernel(const char* name);							//Use a slower kernel, eg. "scalar", to compare them. False if the CPU does not have it, not thread safe
+	protected:
+		static uint8_t simd_level_();										//0 for scalar, 1 for SSE2, 2 for AVX2, the detected level capped by setKernel()
+		static uint8_t kernel_limit_;										//Highest level setKernel() allows
+};
+
+template<class profile>
+class milesTagDecoderT : public milesTagDecoderBase	{
+
+	public:
+		static constexpr uint8_t maximumMessageLength = profile::maximumMessageLength;	//Maximum size of a milesTag message in bytes
+		static constexpr uint16_t startBitLowWatermark = profile::startBitLowWatermark;	//Pulse timing windows in microseconds, exclusive
+		static constexpr uint16_t startBitHighWatermark = profile::startBitHighWatermark;
+		static constexpr uint16_t zeroBitLowWatermark = profile::zeroBitLowWatermark;
+		static constexpr uint16_t zeroBitHighWatermark = profile::zeroBitHighWatermark;
+		static constexpr uint16_t oneBitLowWatermark = profile::oneBitLowWatermark;
+		static constexpr uint16_t oneBitHighWatermark = profile::oneBitHighWatermark;
+		static constexpr uint16_t gapLowWatermark = profile::gapLowWatermark;
+		static constexpr uint16_t gapHighWatermark = profile::gapHighWatermark;
+		static constexpr uint16_t nominalOnTime[3] = {profile::zeroOnTime, profile::oneOnTime, profile::startOnTime};	//Indexed by classification
+		static uint8_t classifySymbol(milesTagSymbol symbol);				//Classify one symbol as zero/one/start/invalid
+		static void classifySymbols(const milesTagSymbol* symbols,			//Classify a run of symbols, using SIMD where the host has it
+			uint8_t numberOfSymbols,
+			uint8_t* classification);
+		static bool decode(const milesTagSymbol* symbols,					//Decode a single capture, true if it is a valid damage packet
+			uint8_t numberOfSymbols,
+			milesTagPacket &packet);
+		static bool decodeCapture(milesTagSymbol* symbols,					//Glitch filter a capture in place, if either threshold is set, then decode it. This is what milesTagClass does with each capture
+			uint8_t &numberOfSymbols,											//Updated to the number left after filtering
+			milesTagPacket &packet,
+			uint16_t minimumPulse = 0,
+			uint16_t minimumGap = 0);
+		static constexpr uint8_t maximumBatchThreads = 64;					//decodeBatch() never starts more threads than this, whatever the core count
+		static uint32_t decodeBatch(const milesTagSymbol* const* captures,	//Decode many captures, returns the number of valid damage packets
+			const uint8_t* numberOfSymbols,
+			uint32_t numberOfCaptures,
+			milesTagPacket* packets,
+			uint8_t numberOfThreads = 1);									//Threads are only used on hosts, 0 means one per core, up to maximumBatchThreads
+	protected:
+	private:
+		static_assert(profile::maximumMessageLength <= sizeof(milesTagPacket::data), "Messages must fit in milesTagPacket");
+		static_assert(profile::zeroBitHighWatermark <= profile::oneBitLowWatermark && profile::oneBitHighWatermark <= profile::startBitLowWatermark, "Receive windows must not overlap");
+		typedef void (*classify_kernel_t_)(const milesTagSymbol*, uint8_t, uint8_t*);
+		static classify_kernel_t_ select_kernel_();
+		static void classify_symbols_scalar_(const milesTagSymbol* symbols, uint8_t numberOfSymbols, uint8_t* classification);
+		#if defined MILESTAG_DECODER_X86
+			static void classify_symbols_sse2_(const milesTagSymbol* symbols, uint8_t numberOfSymbols, uint8_t* classification);
+			static void classify_symbols_avx2_(const milesTagSymbol* symbols, uint8_t numberOfSymbols, uint8_t* classification);
+		#endif
+		static void decode_range_(const milesTagSymbol* const* captures,	//Decode a contiguous part of a batch
+			const uint8_t* numberOfSymbols,
+			uint32_t first,
+			uint32_t last,
+			milesTagPacket* packets,
+			uint32_t* validPackets);
+};
+typedef milesTagDecoderT<MILESTAG_PROFILE> milesTagDecoder;				//The decoder for the profile in use
+
+//Template implementation, in the header so it can be specialised for any profile
+template<class profile>
+constexpr uint16_t milesTagDecoderT<profile>::nominalOnTime[3];	//Indexed at run time, so it needs a definition before C++17
+template<class profile>
+void milesTagDecoderT<profile>::classify_symbols_scalar_(const milesTagSymbol* symbols, uint8_t numberOfSymbols, uint8_t* classification)
+{
+	for(uint8_t symbol_index_ = 0; symbol_index_ < numberOfSymbols; symbol_index_++)
+	{
+		classification[symbol_index_] = classifySymbol(symbols[symbol_index_]);
+	}
+}
+#if defined MILESTAG_DECODER_X86
+	//Both kernels work on the raw 32-bit symbol words, level0 is bit 15 and level1 is bit 31, so a valid mark/space pair has (word & 0x80008000) == 0x00008000
+	template<class profile>
+	__attribute__((target("sse2"))) void milesTagDecoderT<profile>::classify_symbols_sse2_(const milesTagSymbol* symbols, uint8_t numberOfSymbols, uint8_t* classification)
+	{
+		const __m128i duration_mask_ = _mm_set1_epi32(0x7FFF);
+		const __m128i level_mask_ = _mm_set1_epi32(0x80008000);
+		const __m128i level_expected_ = _mm_set1_epi32(0x00008000);
+		const __m128i invalid_ = _mm_set1_epi32(invalid);
+		const __m128i one_ = _mm_set1_epi32(one);
+		const __m128i start_ = _mm_set1_epi32(start);
+		uint8_t symbol_index_ = 0;
+		for(; symbol_index_ + 4 <= numberOfSymbols; symbol_index_ += 4)
+		{
+			__m128i word_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&symbols[symbol_index_]));
+			__m128i on_ = _mm_and_si128(word_, duration_mask_);
+			__m128i off_ = _mm_and_si128(_mm_srli_epi32(word_, 16), duration_mask_);
+			__m128i valid_ = _mm_cmpeq_epi32(_mm_and_si128(word_, level_mask_), level_expected_);
+			__m128i gap_ = _mm_or_si128(_mm_and_si128(_mm_cmpgt_epi32(off_, _mm_set1_epi32(profile::gapLowWatermark)), _mm_cmplt_epi32(off_, _mm_set1_epi32(profile::gapHighWatermark))),
+				_mm_cmpeq_epi32(off_, _mm_setzero_si128()));
+			valid_ = _mm_and_si128(valid_, gap_);
+			__m128i is_zero_ = _mm_and_si128(valid_, _mm_and_si128(_mm_cmpgt_epi32(on_, _mm_set1_epi32(profile::zeroBitLowWatermark)), _mm_cmplt_epi32(on_, _mm_set1_epi32(profile::zeroBitHighWatermark))));
+			__m128i is_one_ = _mm_and_si128(valid_, _mm_and_si128(_mm_cmpgt_epi32(on_, _mm_set1_epi32(profile::oneBitLowWatermark)), _mm_cmplt_epi32(on_, _mm_set1_epi32(profile::oneBitHighWatermark))));
+			__m128i is_start_ = _mm_and_si128(valid_, _mm_and_si128(_mm_cmpgt_epi32(on_, _mm_set1_epi32(profile::startBitLowWatermark)), _mm_cmplt_epi32(on_, _mm_set1_epi32(profile::startBitHighWatermark))));
+			__m128i code_ = _mm_andnot_si128(_mm_or_si128(is_zero_, _mm_or_si128(is_one_, is_start_)), invalid_);
+			code_ = _mm_or_si128(code_, _mm_or_si128(_mm_and_si128(is_one_, one_), _mm_and_si128(is_start_, start_)));
+			code_ = _mm_packus_epi16(_mm_packs_epi32(code_, code_), _mm_setzero_si128());	//Narrow the four 32-bit codes to bytes
+			int32_t packed_ = _mm_cvtsi128_si32(code_);
+			memcpy(&classification[symbol_index_], &packed_, 4);
+		}
+		classify_symbols_scalar_(&symbols[symbol_index_], numberOfSymbols - symbol_index_, &classification[symbol_index_]);
+	}
+	template<class profile>
+	__attribute__((target("avx2"))) void milesTagDecoderT<profile>::classify_symbols_avx2_(const milesTagSymbol* symbols, uint8_t numberOfSymbols, uint8_t* classification)
+	{
+		const __m256i duration_mask_ = _mm256_set1_epi32(0x7FFF);
+		const __m256i level_mask_ = _mm256_set1_epi32(0x80008000);
+		const __m256i level_expected_ = _mm256_set1_epi32(0x00008000);
+		const __m256i invalid_ = _mm256_set1_epi32(invalid);
+		const __m256i one_ = _mm256_set1_epi32(one);
+		const __m256i start_ = _mm256_set1_epi32(start);
+		uint8_t symbol_index_ = 0;
+		for(; symbol_index_ + 8 <= numberOfSymbols; symbol_index_ += 8)
+		{
+			__m256i word_ = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&symbols[symbol_index_]));
+			__m256i on_ = _mm256_and_si256(word_, duration_mask_);
+			__m256i off_ = _mm256_and_si256(_mm256_srli_epi32(word_, 16), duration_mask_);
+			__m256i valid_ = _mm256_cmpeq_epi32(_mm256_and_si256(word_, level_mask_), level_expected_);
+			__m256i gap_ = _mm256_or_si256(_mm256_and_si256(_mm256_cmpgt_epi32(off_, _mm256_set1_epi32(profile::gapLowWatermark)), _mm256_cmpgt_epi32(_mm256_set1_epi32(profile::gapHighWatermark), off_)),
+				_mm256_cmpeq_epi32(off_, _mm256_setzero_si256()));
+			valid_ = _mm256_and_si256(valid_, gap_);
+			__m256i is_zero_ = _mm256_and_si256(valid_, _mm256_and_si256(_mm256_cmpgt_epi32(on_, _mm256_set1_epi32(profile::zeroBitLowWatermark)), _mm256_cmpgt_epi32(_mm256_set1_epi32(profile::zeroBitHighWatermark), on_)));
+			__m256i is_one_ = _mm256_and_si256(valid_, _mm256_and_si256(_mm256_cmpgt_epi32(on_, _mm256_set1_epi32(profile::oneBitLowWatermark)), _mm256_cmpgt_epi32(_mm256_set1_epi32(profile::oneBitHighWatermark), on_)));
+			__m256i is_start_ = _mm256_and_si256(valid_, _mm256_and_si256(_mm256_cmpgt_epi32(on_, _mm256_set1_epi32(profile::startBitLowWatermark)), _mm256_cmpgt_epi32(_mm256_set1_epi32(profile::startBitHighWatermark), on_)));
+			__m256i code_ = _mm256_andnot_si256(_mm256_or_si256(is_zero_, _mm256_or_si256(is_one_, is_start_)), invalid_);
+			code_ = _mm256_or_si256(code_, _mm256_or_si256(_mm256_and_si256(is_one_, one_), _mm256_and_si256(is_start_, start_)));
+			code_ = _mm256_packus_epi16(_mm256_packs_epi32(code_, code_), _mm256_setzero_si256());	//Packs work per 128-bit lane, so the codes end up in the bottom of each lane
+			int32_t packed_[2] = {_mm_cvtsi128_si32(_mm256_castsi256_si128(code_)), _mm_cvtsi128_si32(_mm256_extracti128_si256(code_, 1))};
+			memcpy(&classification[symbol_index_], packed_, 8);
+		}
+		classify_symbols_sse2_(&symbols[symbol_index_], numberOfSymbols - symbol_index_, &classification[symbol_index_]);
+	}
+#endif
+template<class profile>
+uint8_t milesTagDecoderT<profile>::classifySymbol(milesTagSymbol symbol)
+{
+	if(symbol.level0 == 1 && symbol.level1 == 0)	//It's high/low
+	{
+		if((symbol.duration1 > profile::gapLowWatermark &&	//Correct gap
+			symbol.duration1 < profile::gapHighWatermark) ||
+			symbol.duration1 == 0)						//End of the packet
+		{
+			if(symbol.duration0 > profile::zeroBitLowWatermark &&	//Probably a zero
+				symbol.duration0 < profile::zeroBitHighWatermark)
+			{
+				return zero;
+			}
+			else if(symbol.duration0 > profile::oneBitLowWatermark &&	//Probably a one
+				symbol.duration0 < profile::oneBitHighWatermark)
+			{
+				return one;
+			}
+			else if(symbol.duration0 > profile::startBitLowWatermark &&	//Probably a start
+				symbol.duration0 < profile::startBitHighWatermark)
+			{
+				return start;
+			}
+		}
+	}
+	return invalid;
+}
+template<class profile>
+void milesTagDecoderT<profile>::classifySymbols(const milesTagSymbol* symbols, uint8_t numberOfSymbols, uint8_t* classification)
+{
+	select_kernel_()(symbols, numberOfSymbols, classification);	//The CPU is only probed once, this is just a compare
+}
+template<class profile>
+typename milesTagDecoderT<profile>::classify_kernel_t_ milesTagDecoderT<profile>::select_kernel_()
+{
+	#if defined MILESTAG_DECODER_X86
+		if(simd_level_() >= 2)
+		{
+			return classify_symbols_avx2_;
+		}
+		if(simd_level_() >= 1)
+		{
+			return classify_symbols_sse2_;
+		}
+	#endif
+	return classify_symbols_scalar_;
+}
+template<class profile>
+bool milesTagDecoderT<profile>::decode(const milesTagSymbol* symbols, uint8_t numberOfSymbols, milesTagPacket &packet)
+{
+	uint8_t classification_[255];
+	classifySymbols(symbols, numberOfSymbols, classification_);
+	bool start_received_ = false;
+	uint8_t start_position_ = 0;
+	uint8_t bit_index_ = 0;
+	for(uint8_t i = 0; i < profile::maximumMessageLength; i++)	//Clear out any old message
+	{
+		packet.data[i] = 0;
+	}
+	packet.numberOfBits = 0;
+	packet.quality = milesTagSignalQuality();
+	int32_t deviation_sum_ = 0;
+	uint16_t worst_deviation_ = 0;
+	uint16_t shortest_gap_ = 0xFFFF;
+	uint16_t longest_gap_ = 0;
+	uint8_t number_of_pulses_ = 0;
+	for(uint16_t symbol_index_ = 0; symbol_index_ < numberOfSymbols; symbol_index_++)
+	{
+		if((symbol_index_ - start_position_) < profile::maximumMessageLength * 8)	//Symbols beyond the longest message are skipped
+		{
+			uint8_t symbol_character_ = classification_[symbol_index_];
+			if(symbol_character_ != invalid && (start_received_ == true || symbol_character_ == start))	//Measure timing while the packet is being parsed, not as a separate pass
+			{
+				milesTagSymbol symbol_ = symbols[symbol_index_];
+				int32_t deviation_ = int32_t(symbol_.duration0) - nominalOnTime[symbol_character_];
+				uint16_t gap_ = symbol_.duration1;
+				deviation_sum_ += deviation_;
+				worst_deviation_ = uint32_t(deviation_ < 0 ? -deviation_ : deviation_) > worst_deviation_ ? (deviation_ < 0 ? -deviation_ : deviation_) : worst_deviation_;
+				shortest_gap_ = (gap_ < shortest_gap_ && gap_ > 0) ? gap_ : shortest_gap_;	//The last gap is zero, it is the end of the capture
+				longest_gap_ = gap_ > longest_gap_ ? gap_ : longest_gap_;
+				number_of_pulses_++;
+			}
+			if(start_received_ == true)
+			{
+				if(symbol_character_ == zero)
+				{
+					bit_index_++;
+				}
+				else if(symbol_character_ == one)
+				{
+					packet.data[bit_index_/8] += 0x01<<(7-bit_index_%8);	//Simply binary maths to fill up the packet which is MSB
+					bit_index_++;
+				}
+				else
+				{
+					packet.numberOfBits = bit_index_;
+					packet.status = milesTagDecodeStatus::invalidSymbol;	//After start, only 1 & 0 are valid
+					return false;
+				}
+			}
+			else if(symbol_character_ == start)	//Start must be received before beginning to parse bits
+			{
+				start_received_ = true;
+				start_position_ = symbol_index_ + 1;
+			}
+			else if(symbol_character_ == invalid)	//Invalid symbols invalidate the whole packet as there is no checksum
+			{
+				packet.status = milesTagDecodeStatus::invalidSymbol;
+				return false;
+			}
+		}
+	}
+	packet.numberOfBits = bit_index_;
+	if(number_of_pulses_ > 0)
+	{
+		packet.quality.meanPulseDeviation = deviation_sum_ / number_of_pulses_;
+		packet.quality.worstPulseDeviation = worst_deviation_;
+		packet.quality.gapJitter = longest_gap_ >= shortest_gap_ ? longest_gap_ - shortest_gap_ : 0;
+		packet.quality.numberOfPulses = number_of_pulses_;
+	}
+	if(start_received_ == false)
+	{
+		packet.status = milesTagDecodeStatus::noStart;
+		return false;
+	}
+	if((packet.data[0] & 0x80) == 0x80)
+	{
+		packet.status = milesTagDecodeStatus::controlPacket;
+		return false;
+	}
+	if(numberOfSymbols != profile::damagePacketBits + 1)
+	{
+		packet.status = milesTagDecodeStatus::wrongLength;
+		return false;
+	}
+	packet.playerId = packet.data[0] & 0b01111111;
+	packet.teamId = (packet.data[1] & 0b11000000)>>6;
+	packet.damage = bitmaskToDamage((packet.data[1] & 0b00111100)>>2);
+	packet.status = milesTagDecodeStatus::ok;
+	return true;
+}
+template<class profile>
+bool milesTagDecoderT<profile>::decodeCapture(milesTagSymbol* symbols, uint8_t &numberOfSymbols, milesTagPacket &packet, uint16_t minimumPulse, uint16_t minimumGap)
+{
+	if(minimumPulse > 0 || minimumGap > 0)
+	{
+		numberOfSymbols = filterGlitches(symbols, numberOfSymbols, minimumPulse, minimumGap);
+	}
+	return decode(symbols, numberOfSymbols, packet);
+}
+template<class profile>
+void milesTagDecoderT<profile>::decode_range_(const milesTagSymbol* const* captures, const uint8_t* numberOfSymbols, uint32_t first, uint32_t last, milesTagPacket* packets, uint32_t* validPackets)
+{
+	uint32_t valid_ = 0;
+	for(uint32_t index = first; index < last; index++)
+	{
+		valid_ += decode(captures[index], numberOfSymbols[index], packets[index]);
+	}
+	*validPackets = valid_;
+}
+template<class profile>
+uint32_t milesTagDecoderT<profile>::decodeBatch(const milesTagSymbol* const* captures, const uint8_t* numberOfSymbols, uint32_t numberOfCaptures, milesTagPacket* packets, uint8_t numberOfThreads)
+{
+	#if defined MILESTAG_DECODER_THREADS
+		const uint32_t minimum_captures_per_thread_ = 1024;	//Below this, starting a thread costs more than it saves
+		unsigned number_of_threads_ = numberOfThreads;	//Kept wide until clamped, hardware_concurrency() can exceed 255
+		if(number_of_threads_ == 0)
+		{
+			number_of_threads_ = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+		}
+		if(number_of_threads_ > maximumBatchThreads)
+		{
+			number_of_threads_ = maximumBatchThreads;
+		}
+		if(numberOfCaptures / minimum_captures_per_thread_ < number_of_threads_)
+		{
+			number_of_threads_ = numberOfCaptures / minimum_captures_per_thread_ > 0 ? numberOfCaptures / minimum_captures_per_thread_ : 1;
+		}
+		numberOfThreads = number_of_threads_;	//At most maximumBatchThreads, so this cannot wrap
+		if(numberOfThreads > 1)
+		{
+			std::vector<std::thread> threads_;
+			std::vector<uint32_t> valid_(numberOfThreads, 0);
+			uint32_t captures_per_thread_ = (numberOfCaptures + numberOfThreads - 1) / numberOfThreads;
+			for(uint8_t thread_ = 0; thread_ < numberOfThreads; thread_++)
+			{
+				uint32_t first_ = thread_ * captures_per_thread_;
+				uint32_t last_ = first_ + captures_per_thread_ < numberOfCaptures ? first_ + captures_per_thread_ : numberOfCaptures;
+				threads_.emplace_back(&milesTagDecoderT<profile>::decode_range_, captures, numberOfSymbols, first_, last_, packets, &valid_[thread_]);
+			}
+			uint32_t total_ = 0;
+			for(uint8_t thread_ = 0; thread_ < numberOfThreads; thread_++)
+			{
+				threads_[thread_].join();
+				total_ += valid_[thread_];
+			}
+			return total_;
+		}
+	#else
+		(void)numberOfThreads;
+	#endif
+	uint32_t total_ = 0;
+	decode_range_(captures, numberOfSymbols, 0, numberOfCaptures, packets, &total_);
+	return total_;
+}
+#endif
@@ -0,0 +1,120 @@
+/*
+ *	An Arduino library for milesTag support
+ *
+ *	https://github.com/ncmreynolds/milesTag
+ *
+ *	Released under LGPL-2.1 see https://github.com/ncmreynolds/milesTag/LICENSE for full license
+ *
+ */
+#ifndef milesTagEncoder_cpp
+#define milesTagEncoder_cpp
+#include "milesTagEncoder.h"
+
+uint8_t milesTagEncoderBase::damageToBitmask(uint8_t damage)
+{
+	switch(damage)
+	{
+		case 0 ... 1:
+			return 0b00000000;
+			break;
+		case 2 ... 3:
+			return 0b00000001;
+			break;
+		case 4:
+			return 0b00000010;
+			break;
+		case 5 ... 6:
+			return 0b00000011;
+			break;
+		case 7 ... 9:
+			return 0b00000100;
+			break;
+		case 10 ... 14:
+			return 0b00000101;
+			break;
+		case 15 ... 16:
+			return 0b00000110;
+			break;
+		case 17 ... 19:
+			return 0b00000111;
+			break;
+		case 20 ... 24:
+			return 0b00001000;
+			break;
+		case 25 ... 29:
+			return 0b00001001;
+			break;
+		case 30 ... 34:
+			return 0b00001010;
+			break;
+		case 35 ... 39:
+			return 0b00001011;
+			break;
+		case 40 ... 49:
+			return 0b00001100;
+			break;
+		case 50 ... 74:
+			return 0b00001101;
+			break;
+		case 75 ... 99:
+			return 0b00001110;
+			break;
+		case 100:
+			return 0b00001111;
+			break;
+		default:
+			return 0b00000000;
+			break;
+	}
+	return 0b00000000;
+}
+void milesTagEncoderBase::packDamage(uint8_t playerId, uint8_t teamId, uint8_t damage, uint8_t* data)
+{
+	data[0] = playerId & 0b01111111;										//Player ID is in bottom 7 bits of byte 0, the top bit is always zero for damage
+	data[1] = ((uint8_t)teamId) << 6;										//Team ID is in top two bits of byte 1
+	data[1] = data[1] | ((damageToBitmask(damage)) << 2);					//Damage is in next four bits of byte 1, others are not sent
+}
+uint32_t milesTagEncoderBase::duration(const milesTagSymbol* symbols, uint8_t numberOfSymbols)
+{
+	uint32_t duration_ = 0;
+	for(uint8_t index = 0; index < numberOfSymbols; index++)
+	{
+		duration_ += symbols[index].duration0 + symbols[index].duration1;
+	}
+	return duration_;
+}
+uint8_t milesTagEncoderBase::appendGap(uint32_t gap, milesTagSymbol* symbols, uint8_t numberOfSymbols, uint8_t maximumNumberOfSymbols)
+{
+	if(numberOfSymbols == 0 || gap == 0)
+	{
+		return 0;
+	}
+	const uint8_t last_symbol_ = numberOfSymbols - 1;
+	const uint16_t previous_gap_ = symbols[last_symbol_].duration1;	//Put back if the gap does not fit
+	uint32_t remaining_ = gap;
+	symbols[last_symbol_].duration1 = remaining_ > longestDuration ? longestDuration : remaining_;
+	remaining_ -= symbols[last_symbol_].duration1;
+	while(remaining_ > 0)	//Idle symbols, both halves must be non-zero as a zero duration ends the transmission
+	{
+		if(numberOfSymbols == maximumNumberOfSymbols)
+		{
+			symbols[last_symbol_].duration1 = previous_gap_;	//Leave the symbols as they were, idle symbols already written are beyond the caller's count
+			return 0;
+		}
+		if(remaining_ == 1)	//Too short for a symbol of its own, take a microsecond from the previous one
+		{
+			symbols[numberOfSymbols - 1].duration1--;
+			remaining_ = 2;
+		}
+		uint32_t first_half_ = remaining_ > 2 * longestDuration ? longestDuration : remaining_ / 2;
+		uint32_t second_half_ = remaining_ - first_half_ > longestDuration ? longestDuration : remaining_ - first_half_;
+		symbols[numberOfSymbols].duration0 = first_half_;
+		symbols[numberOfSymbols].level0 = 0;
+		symbols[numberOfSymbols].duration1 = second_half_;
+		symbols[numberOfSymbols].level1 = 0;
+		remaining_ -= first_half_ + second_half_;
+		numberOfSymbols++;
+	}
+	return numberOfSymbols;
+}
+#endif
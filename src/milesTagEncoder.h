@@ -0,0 +1,88 @@
+/*
+ *	An Arduino library for milesTag support
+ *
+ *	https://github.com/ncmreynolds/milesTag
+ *
+ *	Released under LGPL-2.1 see https://github.com/ncmreynolds/milesTag/LICENSE for full license
+ *
+ *	Platform independent packet encoder, used by milesTagClass for transmission and by simulations to generate traffic
+ *
+ *	milesTagEncoderT is specialised for a timing profile from milesTagProfile.h, milesTagEncoder is the one for MILESTAG_PROFILE
+ *
+ */
+#ifndef milesTagEncoder_h
+#define milesTagEncoder_h
+#include "milesTagDecoder.h"	//For milesTagSymbol
+
+class milesTagEncoderBase	{													//The parts of the encoder that do not depend on the protocol timings
+
+	public:
+		static uint8_t damageToBitmask(uint8_t damage);						//Turn a numeric damage value into a bitmask for packing into a packet
+		static void packDamage(uint8_t playerId,							//Pack the two data bytes of a 'damage' packet, eg. to queue it for encoding later
+			uint8_t teamId,
+			uint8_t damage,
+			uint8_t* data);
+		static uint32_t duration(const milesTagSymbol* symbols,				//Total duration of some symbols in microseconds
+			uint8_t numberOfSymbols);
+		static uint8_t appendGap(uint32_t gap,								//Make the silence after the last of some symbols exactly this long in microseconds, adding idle symbols if it does not fit in 15 bits
+			milesTagSymbol* symbols,
+			uint8_t numberOfSymbols,
+			uint8_t maximumNumberOfSymbols);								//Returns the new number of symbols or 0, with the symbols unchanged, if they do not fit
+		static const uint16_t longestDuration = 0x7FFF;						//Longest single pulse or gap in a symbol
+};
+
+template<class profile>
+class milesTagEncoderT : public milesTagEncoderBase	{
+
+	public:
+		static constexpr uint16_t startOnTime = profile::startOnTime;		//Start on time  ie. how long to send carrier for to indicate a start bit
+		static constexpr uint16_t zeroOnTime = profile::zeroOnTime;			//Zero on time ie. how long to send carrier for to indicate a zero bit
+		static constexpr uint16_t oneOnTime = profile::oneOnTime;			//One on time ie. how long to send carrier for to indicate a one bit
+		static constexpr uint16_t offTime = profile::offTime;				//Off time ie. how long to leave between bits
+		static constexpr uint8_t damagePacketBits = profile::damagePacketBits;	//Player ID, team ID and damage
+		static constexpr uint8_t damagePacketSymbols = profile::damagePacketBits + 1;
+		static uint8_t encodePacket(const uint8_t* data,					//Encode a start symbol followed by the bits of data, MSB first, returns the number of symbols or 0 if they do not fit
+			uint8_t numberOfBits,
+			milesTagSymbol* symbols,
+			uint8_t maximumNumberOfSymbols);
+		static uint8_t encodeDamage(uint8_t playerId,						//Encode a 'damage' packet, returns the number of symbols or 0 if they do not fit
+			uint8_t teamId,
+			uint8_t damage,
+			milesTagSymbol* symbols,
+			uint8_t maximumNumberOfSymbols);
+	protected:
+	private:
+};
+typedef milesTagEncoderT<MILESTAG_PROFILE> milesTagEncoder;				//The encoder for the profile in use
+
+//Template implementation, in the header so it can be specialised for any profile
+template<class profile>
+uint8_t milesTagEncoderT<profile>::encodePacket(const uint8_t* data, uint8_t numberOfBits, milesTagSymbol* symbols, uint8_t maximumNumberOfSymbols)
+{
+	if(numberOfBits + 1 > maximumNumberOfSymbols || numberOfBits > profile::maximumMessageLength * 8)
+	{
+		return 0;
+	}
+	//Add the milesTag 'start' signal to the buffer
+	symbols[0].duration0 = startOnTime;
+	symbols[0].level0 = 1;
+	symbols[0].duration1 = offTime;
+	symbols[0].level1 = 0;
+	//Continue filling the buffer after the 'start' signal
+	for(uint8_t bitIndex = 0; bitIndex < numberOfBits; bitIndex++)
+	{
+		symbols[bitIndex + 1].duration0 = ((data[bitIndex/8] >> (7 - bitIndex%8)) & 0x01) ? oneOnTime : zeroOnTime;
+		symbols[bitIndex + 1].level0 = 1;
+		symbols[bitIndex + 1].duration1 = offTime;
+		symbols[bitIndex + 1].level1 = 0;
+	}
+	return numberOfBits + 1;
+}
+template<class profile>
+uint8_t milesTagEncoderT<profile>::encodeDamage(uint8_t playerId, uint8_t teamId, uint8_t damage, milesTagSymbol* symbols, uint8_t maximumNumberOfSymbols)
+{
+	uint8_t dataToSend[2] = {0,0};
+	packDamage(playerId, teamId, damage, dataToSend);
+	return encodePacket(dataToSend, profile::damagePacketBits, symbols, maximumNumberOfSymbols);
+}
+#endif
@@ -0,0 +1,70 @@
+/*
+ *	An Arduino library for milesTag support
+ *
+ *	https://github.com/ncmreynolds/milesTag
+ *
+ *	Released under LGPL-2.1 see https://github.com/ncmreynolds/milesTag/LICENSE for full license
+ *
+ *	Protocol timing profiles. The encoder and decoder are templates on one of these, so every timing and threshold is a compile time constant
+ *
+ *	Both ends of a link must use the same profile. The profile used by milesTagClass is set with the MILESTAG_PROFILE build flag, eg. -DMILESTAG_PROFILE=milesTagProfileDoubleRate
+ *	A profile defined outside the library can be made available to it with -DMILESTAG_PROFILE_INCLUDE="\"myProfile.h\""
+ *
+ */
+#ifndef milesTagProfile_h
+#define milesTagProfile_h
+#include <stdint.h>
+
+template<uint16_t startOnTime_,												//Nominal pulse and gap lengths in microseconds
+	uint16_t zeroOnTime_,
+	uint16_t oneOnTime_,
+	uint16_t offTime_,
+	uint32_t carrierFrequency_ = 56000,										//Carrier in Hz
+	uint16_t tolerance_ = 40,												//Allowed error either side of nominal in microseconds
+	uint16_t stretch_ = 40>													//Extra allowance for IR receiver modules lengthening pulses and shortening gaps
+struct milesTagTimingProfile {
+	static constexpr uint16_t startOnTime = startOnTime_;
+	static constexpr uint16_t zeroOnTime = zeroOnTime_;
+	static constexpr uint16_t oneOnTime = oneOnTime_;
+	static constexpr uint16_t offTime = offTime_;
+	static constexpr uint32_t carrierFrequency = carrierFrequency_;
+	//Receive windows, exclusive, derived from the nominal timings
+	static constexpr uint16_t startBitLowWatermark = startOnTime - tolerance_;
+	static constexpr uint16_t startBitHighWatermark = startOnTime + tolerance_ + stretch_;
+	static constexpr uint16_t zeroBitLowWatermark = zeroOnTime - tolerance_;
+	static constexpr uint16_t zeroBitHighWatermark = zeroOnTime + tolerance_ + stretch_;
+	static constexpr uint16_t oneBitLowWatermark = oneOnTime - tolerance_;
+	static constexpr uint16_t oneBitHighWatermark = oneOnTime + tolerance_ + stretch_;
+	static constexpr uint16_t gapLowWatermark = offTime - tolerance_ - stretch_;
+	static constexpr uint16_t gapHighWatermark = offTime + tolerance_;
+	static constexpr uint32_t receiveIdleThreshold = startOnTime + offTime - tolerance_;	//A gap this long (in microseconds) ends a capture
+	//Packet layout
+	static constexpr uint8_t maximumMessageLength = 3;						//Maximum size of a message in bytes
+	static constexpr uint8_t damagePacketBits = 14;							//Player ID, team ID and damage
+	static_assert(startOnTime_ < 0x8000 && offTime_ < 0x8000, "Timings must fit in 15 bits");
+	static_assert(zeroOnTime_ > tolerance_ && offTime_ > tolerance_ + stretch_, "Tolerance is too large for these timings");
+	static_assert(zeroOnTime_ + tolerance_ + stretch_ <= oneOnTime_ - tolerance_ && oneOnTime_ + tolerance_ + stretch_ <= startOnTime_ - tolerance_, "Receive windows must not overlap");
+};
+
+struct milesTagProfileMilesTag2 : milesTagTimingProfile<2400, 600, 1200, 600> {	//MilesTag 2 as used since the first release, with its hand tuned receive windows
+	static constexpr uint16_t startBitLowWatermark = 2200;
+	static constexpr uint16_t startBitHighWatermark = 2480;
+	static constexpr uint16_t zeroBitLowWatermark = 590;
+	static constexpr uint16_t zeroBitHighWatermark = 680;
+	static constexpr uint16_t oneBitLowWatermark = 1190;
+	static constexpr uint16_t oneBitHighWatermark = 1280;
+	static constexpr uint16_t gapLowWatermark = 520;
+	static constexpr uint16_t gapHighWatermark = 680;
+	static constexpr uint32_t receiveIdleThreshold = 2800;
+};
+
+struct milesTagProfileDoubleRate : milesTagTimingProfile<1200, 300, 600, 300> {	//Not MilesTag compatible, half the timings for twice the shot throughput. 300us is ~17 carrier cycles, check your IR receiver's minimum burst length
+};
+
+#if defined MILESTAG_PROFILE_INCLUDE
+	#include MILESTAG_PROFILE_INCLUDE
+#endif
+#if !defined MILESTAG_PROFILE
+	#define MILESTAG_PROFILE milesTagProfileMilesTag2
+#endif
+#endif
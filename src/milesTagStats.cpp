@@ -0,0 +1,314 @@
+/*
+ *	An Arduino library for milesTag support
+ *
+ *	https://github.com/ncmreynolds/milesTag
+ *
+ *	Released under LGPL-2.1 see https://github.com/ncmreynolds/milesTag/LICENSE for full license
+ *
+ */
+#ifndef milesTagStats_cpp
+#define milesTagStats_cpp
+#include "milesTagStats.h"
+#include <string.h>
+
+milesTagStats::milesTagStats()	//Constructor function
+{
+	reset();
+}
+
+milesTagStats::~milesTagStats()	//Destructor function
+{
+}
+void milesTagStats::recordHit(uint8_t playerId, uint8_t teamId, uint8_t damage, uint32_t timestamp)
+{
+	if(playerId < maximumPlayers && teamId < maximumTeams)	//Invalid IDs are ignored rather than counted against another player
+	{
+		hits_from_player_[playerId]++;
+		damage_from_player_[playerId] += damage;
+		last_hit_from_player_[playerId] = timestamp;
+		player_changed_[playerId/8] |= 0x01<<(playerId%8);
+		hits_from_team_[teamId]++;
+		damage_from_team_[teamId] += damage;
+		last_hit_from_team_[teamId] = timestamp;
+		team_changed_ |= 0x01<<teamId;
+	}
+}
+void milesTagStats::recordShot(uint8_t transmitterIndex, uint32_t timestamp)
+{
+	if(transmitterIndex < maximumTransmitters)
+	{
+		shots_fired_[transmitterIndex]++;
+		last_shot_[transmitterIndex] = timestamp;
+		transmitter_changed_ |= 0x01<<transmitterIndex;
+	}
+}
+void milesTagStats::reset()
+{
+	memset(hits_from_player_, 0, sizeof(hits_from_player_));
+	memset(damage_from_player_, 0, sizeof(damage_from_player_));
+	memset(last_hit_from_player_, 0, sizeof(last_hit_from_player_));
+	memset(hits_from_team_, 0, sizeof(hits_from_team_));
+	memset(damage_from_team_, 0, sizeof(damage_from_team_));
+	memset(last_hit_from_team_, 0, sizeof(last_hit_from_team_));
+	memset(shots_fired_, 0, sizeof(shots_fired_));
+	memset(last_shot_, 0, sizeof(last_shot_));
+	memset(player_changed_, 0, sizeof(player_changed_));
+	team_changed_ = 0;
+	transmitter_changed_ = 0;
+	full_snapshot_due_ = true;
+}
+uint16_t milesTagStats::hitsTakenFromPlayer(uint8_t playerId)
+{
+	return playerId < maximumPlayers ? hits_from_player_[playerId] : 0;
+}
+uint32_t milesTagStats::damageTakenFromPlayer(uint8_t playerId)
+{
+	return playerId < maximumPlayers ? damage_from_player_[playerId] : 0;
+}
+uint32_t milesTagStats::lastHitFromPlayer(uint8_t playerId)
+{
+	return playerId < maximumPlayers ? last_hit_from_player_[playerId] : 0;
+}
+uint16_t milesTagStats::hitsTakenFromTeam(uint8_t teamId)
+{
+	return teamId < maximumTeams ? hits_from_team_[teamId] : 0;
+}
+uint32_t milesTagStats::damageTakenFromTeam(uint8_t teamId)
+{
+	return teamId < maximumTeams ? damage_from_team_[teamId] : 0;
+}
+uint32_t milesTagStats::lastHitFromTeam(uint8_t teamId)
+{
+	return teamId < maximumTeams ? last_hit_from_team_[teamId] : 0;
+}
+uint32_t milesTagStats::shotsFired(uint8_t transmitterIndex)
+{
+	return transmitterIndex < maximumTransmitters ? shots_fired_[transmitterIndex] : 0;
+}
+uint32_t milesTagStats::lastShot(uint8_t transmitterIndex)
+{
+	return transmitterIndex < maximumTransmitters ? last_shot_[transmitterIndex] : 0;
+}
+uint32_t milesTagStats::totalHitsTaken()
+{
+	uint32_t total_ = 0;
+	for(uint8_t index = 0; index < maximumTeams; index++)	//Every hit is counted against exactly one team
+	{
+		total_ += hits_from_team_[index];
+	}
+	return total_;
+}
+uint32_t milesTagStats::totalDamageTaken()
+{
+	uint32_t total_ = 0;
+	for(uint8_t index = 0; index < maximumTeams; index++)
+	{
+		total_ += damage_from_team_[index];
+	}
+	return total_;
+}
+uint16_t milesTagStats::serialiseSnapshot(uint8_t* buffer, uint16_t bufferSize, uint32_t timestamp, bool full)
+{
+	if(bufferSize < snapshotHeaderLength)
+	{
+		return 0;
+	}
+	if(full == true || full_snapshot_due_ == true)	//Deltas against zero, for every non-zero entry
+	{
+		full = true;
+		full_snapshot_due_ = false;
+		memset(sent_hits_from_player_, 0, sizeof(sent_hits_from_player_));
+		memset(sent_damage_from_player_, 0, sizeof(sent_damage_from_player_));
+		memset(sent_hits_from_team_, 0, sizeof(sent_hits_from_team_));
+		memset(sent_damage_from_team_, 0, sizeof(sent_damage_from_team_));
+		memset(sent_shots_fired_, 0, sizeof(sent_shots_fired_));
+		for(uint8_t index = 0; index < maximumPlayers; index++)
+		{
+			if(hits_from_player_[index] > 0)
+			{
+				player_changed_[index/8] |= 0x01<<(index%8);
+			}
+		}
+		for(uint8_t index = 0; index < maximumTeams; index++)
+		{
+			if(hits_from_team_[index] > 0)
+			{
+				team_changed_ |= 0x01<<index;
+			}
+		}
+		for(uint8_t index = 0; index < maximumTransmitters; index++)
+		{
+			if(shots_fired_[index] > 0)
+			{
+				transmitter_changed_ |= 0x01<<index;
+			}
+		}
+	}
+	snapshot_sequence_++;
+	buffer[0] = snapshotFormatVersion;
+	buffer[1] = full ? 0x01 : 0x00;
+	buffer[2] = snapshot_sequence_ & 0xFF;
+	buffer[3] = snapshot_sequence_ >> 8;
+	for(uint8_t byte_ = 0; byte_ < 4; byte_++)
+	{
+		buffer[4 + byte_] = (timestamp >> (8 * byte_)) & 0xFF;
+	}
+	uint16_t length_ = snapshotHeaderLength;
+	const uint8_t longest_record_ = 1 + 3 * 5;	//Tag and three varints
+	for(uint8_t index = 0; index < maximumPlayers && length_ + longest_record_ <= bufferSize; index++)
+	{
+		if(player_changed_[index/8] & (0x01<<(index%8)))
+		{
+			buffer[length_++] = index;
+			length_ += write_varint_(&buffer[length_], uint16_t(hits_from_player_[index] - sent_hits_from_player_[index]));
+			length_ += write_varint_(&buffer[length_], damage_from_player_[index] - sent_damage_from_player_[index]);
+			length_ += write_varint_(&buffer[length_], timestamp - last_hit_from_player_[index]);
+			sent_hits_from_player_[index] = hits_from_player_[index];
+			sent_damage_from_player_[index] = damage_from_player_[index];
+			player_changed_[index/8] &= ~(0x01<<(index%8));
+		}
+	}
+	for(uint8_t index = 0; index < maximumTeams && length_ + longest_record_ <= bufferSize; index++)
+	{
+		if(team_changed_ & (0x01<<index))
+		{
+			buffer[length_++] = 0x80 | index;
+			length_ += write_varint_(&buffer[length_], uint16_t(hits_from_team_[index] - sent_hits_from_team_[index]));
+			length_ += write_varint_(&buffer[length_], damage_from_team_[index] - sent_damage_from_team_[index]);
+			length_ += write_varint_(&buffer[length_], timestamp - last_hit_from_team_[index]);
+			sent_hits_from_team_[index] = hits_from_team_[index];
+			sent_damage_from_team_[index] = damage_from_team_[index];
+			team_changed_ &= ~(0x01<<index);
+		}
+	}
+	for(uint8_t index = 0; index < maximumTransmitters && length_ + longest_record_ <= bufferSize; index++)
+	{
+		if(transmitter_changed_ & (0x01<<index))
+		{
+			buffer[length_++] = 0xC0 | index;
+			length_ += write_varint_(&buffer[length_], shots_fired_[index] - sent_shots_fired_[index]);
+			length_ += write_varint_(&buffer[length_], timestamp - last_shot_[index]);
+			sent_shots_fired_[index] = shots_fired_[index];
+			transmitter_changed_ &= ~(0x01<<index);
+		}
+	}
+	return length_;
+}
+bool milesTagStats::applySnapshot(const uint8_t* buffer, uint16_t length)
+{
+	if(length < snapshotHeaderLength || buffer[0] != snapshotFormatVersion)
+	{
+		return false;
+	}
+	bool full_ = buffer[1] & 0x01;
+	uint16_t sequence_ = buffer[2] | (uint16_t(buffer[3]) << 8);
+	if(full_ == false && sequence_ != uint16_t(snapshot_sequence_ + 1))
+	{
+		return false;	//A delta was lost, a full snapshot is needed
+	}
+	uint32_t timestamp_ = 0;
+	for(uint8_t byte_ = 0; byte_ < 4; byte_++)
+	{
+		timestamp_ |= uint32_t(buffer[4 + byte_]) << (8 * byte_);
+	}
+	for(uint16_t position_ = snapshotHeaderLength; position_ < length;)	//Check every record before changing anything, so a truncated or malformed snapshot leaves the tables as they were
+	{
+		uint8_t tag_ = 0;
+		uint32_t values_[3];
+		uint8_t used_ = read_record_(buffer, length, position_, tag_, values_);
+		if(used_ == 0)
+		{
+			return false;
+		}
+		position_ += used_;
+	}
+	if(full_ == true)
+	{
+		reset();
+		full_snapshot_due_ = false;
+	}
+	for(uint16_t position_ = snapshotHeaderLength; position_ < length;)
+	{
+		uint8_t tag_ = 0;
+		uint32_t values_[3] = {0, 0, 0};
+		position_ += read_record_(buffer, length, position_, tag_, values_);
+		if((tag_ & 0x80) == 0x00)
+		{
+			hits_from_player_[tag_] += values_[0];
+			damage_from_player_[tag_] += values_[1];
+			last_hit_from_player_[tag_] = timestamp_ - values_[2];
+		}
+		else if((tag_ & 0xE0) == 0xC0)
+		{
+			uint8_t index = tag_ & 0x1F;
+			if(index < maximumTransmitters)
+			{
+				shots_fired_[index] += values_[0];
+				last_shot_[index] = timestamp_ - values_[1];
+			}
+		}
+		else
+		{
+			uint8_t index = tag_ & 0x03;
+			hits_from_team_[index] += values_[0];
+			damage_from_team_[index] += values_[1];
+			last_hit_from_team_[index] = timestamp_ - values_[2];
+		}
+	}
+	snapshot_sequence_ = sequence_;
+	return true;
+}
+uint16_t milesTagStats::snapshotSequence()
+{
+	return snapshot_sequence_;
+}
+uint8_t milesTagStats::read_record_(const uint8_t* buffer, uint16_t length, uint16_t position, uint8_t &tag, uint32_t* values)
+{
+	uint16_t start_ = position;
+	tag = buffer[position++];
+	if((tag & 0x80) == 0x80 && (tag & 0xE0) != 0xC0 && (tag & 0xFC) != 0x80)
+	{
+		return 0;	//Unknown record type
+	}
+	uint8_t number_of_values_ = (tag & 0xE0) == 0xC0 ? 2 : 3;
+	for(uint8_t value_ = 0; value_ < number_of_values_; value_++)
+	{
+		uint8_t used_ = read_varint_(&buffer[position], length - position, values[value_]);
+		if(used_ == 0)
+		{
+			return 0;
+		}
+		position += used_;
+	}
+	return position - start_;
+}
+uint8_t milesTagStats::write_varint_(uint8_t* buffer, uint32_t value)
+{
+	uint8_t length_ = 0;
+	do
+	{
+		buffer[length_] = value & 0x7F;
+		value = value >> 7;
+		if(value > 0)
+		{
+			buffer[length_] |= 0x80;	//More bytes follow
+		}
+		length_++;
+	}
+	while(value > 0);
+	return length_;
+}
+uint8_t milesTagStats::read_varint_(const uint8_t* buffer, uint16_t length, uint32_t &value)
+{
+	value = 0;
+	for(uint8_t length_ = 0; length_ < length && length_ < 5; length_++)
+	{
+		value |= uint32_t(buffer[length_] & 0x7F) << (7 * length_);
+		if((buffer[length_] & 0x80) == 0)
+		{
+			return length_ + 1;
+		}
+	}
+	return 0;
+}
+#endif
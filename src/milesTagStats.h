@@ -0,0 +1,96 @@
+/*
+ *	An Arduino library for milesTag support
+ *
+ *	https://github.com/ncmreynolds/milesTag
+ *
+ *	Released under LGPL-2.1 see https://github.com/ncmreynolds/milesTag/LICENSE for full license
+ *
+ *	Optional game statistics, kept in fixed flat tables so recording a hit or shot is a couple of array writes
+ *
+ *	Snapshots are a compact binary format containing only the entries that changed since the previous snapshot
+ *
+ *	Header, 8 bytes
+ *		uint8_t		format version, currently 1
+ *		uint8_t		flags, bit 0 set for a full snapshot where the receiver should clear its copy first
+ *		uint16_t	sequence number, little endian, so the receiver can spot a lost snapshot and ask for a full one
+ *		uint32_t	snapshot time, little endian, the same clock as the timestamps passed in
+ *	Then records, each a tag byte followed by unsigned LEB128 varints
+ *		0ppppppp	hits taken from player p, varint hits delta, varint damage delta, varint age of the last hit
+ *		100000tt	hits taken from team t, varint hits delta, varint damage delta, varint age of the last hit
+ *		110xxxxx	shots fired from transmitter x, varint shots delta, varint age of the last shot
+ *	Deltas are against the previous snapshot, or zero in a full snapshot. Ages are the snapshot time minus the timestamp
+ *
+ */
+#ifndef milesTagStats_h
+#define milesTagStats_h
+#include <stdint.h>
+#include <stddef.h>
+
+class milesTagStats	{
+
+	public:
+		static const uint8_t maximumPlayers = 128;							//Player IDs are 0-127
+		static const uint8_t maximumTeams = 4;								//Team IDs are 0-3
+		static const uint8_t maximumTransmitters = 8;						//More than any ESP32 has RMT channels for
+		static const uint8_t snapshotFormatVersion = 1;
+		static const uint8_t snapshotHeaderLength = 8;
+		milesTagStats();													//Constructor function
+		~milesTagStats();													//Destructor function
+		void recordHit(uint8_t playerId,									//Record a hit taken, eg. with receivedPlayerId(), receivedTeamId() and receivedDamage(). Out of range IDs are ignored
+			uint8_t teamId,
+			uint8_t damage,
+			uint32_t timestamp);
+		void recordShot(uint8_t transmitterIndex,							//Record a shot fired from a transmitter, out of range indices are ignored
+			uint32_t timestamp);
+		void reset();														//Clear everything, the next snapshot will be a full one
+		uint16_t hitsTakenFromPlayer(uint8_t playerId);
+		uint32_t damageTakenFromPlayer(uint8_t playerId);
+		uint32_t lastHitFromPlayer(uint8_t playerId);						//Timestamp of the last hit, 0 if never hit
+		uint16_t hitsTakenFromTeam(uint8_t teamId);
+		uint32_t damageTakenFromTeam(uint8_t teamId);
+		uint32_t lastHitFromTeam(uint8_t teamId);
+		uint32_t shotsFired(uint8_t transmitterIndex);
+		uint32_t lastShot(uint8_t transmitterIndex);
+		uint32_t totalHitsTaken();
+		uint32_t totalDamageTaken();
+		uint16_t serialiseSnapshot(uint8_t* buffer,							//Write the entries changed since the last snapshot, returns the length used. Anything that does not fit is sent next time
+			uint16_t bufferSize,
+			uint32_t timestamp,
+			bool full = false);												//Send every non-zero entry as an absolute value, eg. after a lost snapshot
+		bool applySnapshot(const uint8_t* buffer,							//Update these tables from a snapshot, eg. on a game server mirroring a player. False if it is malformed or out of sequence, the tables are then left unchanged
+			uint16_t length);
+		uint16_t snapshotSequence();										//Sequence number of the last snapshot written or applied
+	protected:
+	private:
+		//Tables indexed by the ID of the player/team that did the hitting
+		uint16_t hits_from_player_[maximumPlayers];
+		uint32_t damage_from_player_[maximumPlayers];
+		uint32_t last_hit_from_player_[maximumPlayers];
+		uint16_t hits_from_team_[maximumTeams];
+		uint32_t damage_from_team_[maximumTeams];
+		uint32_t last_hit_from_team_[maximumTeams];
+		uint32_t shots_fired_[maximumTransmitters];
+		uint32_t last_shot_[maximumTransmitters];
+		//Values in the last snapshot, which deltas are taken against
+		uint16_t sent_hits_from_player_[maximumPlayers];
+		uint32_t sent_damage_from_player_[maximumPlayers];
+		uint16_t sent_hits_from_team_[maximumTeams];
+		uint32_t sent_damage_from_team_[maximumTeams];
+		uint32_t sent_shots_fired_[maximumTransmitters];
+		//Changed since the last snapshot, one bit per entry
+		uint8_t player_changed_[maximumPlayers/8];
+		uint8_t team_changed_ = 0;
+		uint8_t transmitter_changed_ = 0;
+		uint16_t snapshot_sequence_ = 0;
+		bool full_snapshot_due_ = true;										//The first snapshot is always full
+		static uint8_t write_varint_(uint8_t* buffer, uint32_t value);		//Returns the number of bytes used, at most 5
+		static uint8_t read_varint_(const uint8_t* buffer,					//Returns the number of bytes used, 0 if it runs off the end
+			uint16_t length,
+			uint32_t &value);
+		static uint8_t read_record_(const uint8_t* buffer,					//Read the tag and values of the record at position, returns the number of bytes used, 0 if it is malformed or runs off the end
+			uint16_t length,
+			uint16_t position,
+			uint8_t &tag,
+			uint32_t* values);
+};
+#endif